@@ -0,0 +1,281 @@
+/* 03_render_benchmark.cpp
+ *
+ * Headless rendering benchmark: runs the engine frame loop with the software renderer (no window, no GPU needed)
+ * for a fixed number of frames, then reports per-stage timings, draw stats of the last frame and a checksum of the final framebuffer.
+ * The scene is fully deterministic (fixed delta, no input, no randomness), so the checksum only changes
+ * when the rendering output of sprites, tilemaps, particles or debug-draw changes.
+ *
+ * with `threaded` set to 1 simulation runs on its own thread at a fixed tick (see `itu_sys_simthread`), and the main loop
+ * only renders the latest snapshot. In this mode frames are interpolated with the wall clock, so the checksum is NOT deterministic
+ *
+ * usage: 03_render_benchmark [frames_count] [width] [height] [workers_count] [threaded]
+ */
+
+#define TEXTURE_PIXELS_PER_UNIT 16
+#define CAMERA_PIXELS_PER_UNIT  32
+
+// physics timestep (physics is not used, but the default physics system needs it)
+#define PHYSICS_TIMESTEP_NSECS  (SECONDS(1) / 60)
+#define PHYSICS_TIMESTEP_SECS   NS_TO_SECONDS(PHYSICS_TIMESTEP_NSECS)
+#define PHYSICS_MAX_TIMESTEPS_PER_FRAME 4
+
+#define WINDOW_W         1280
+#define WINDOW_H         720
+
+#include <itu_unity_include.hpp>
+
+#define BENCHMARK_FRAMES_DEFAULT 600
+#define BENCHMARK_SPRITES_COUNT  4096
+#define BENCHMARK_TILEMAP_SIZE   256
+#define BENCHMARK_EMITTERS_COUNT 8
+#define BENCHMARK_PARTICLES_PER_EMITTER 16384
+
+#define TILESET_TILE_SIZE 16
+#define TILESET_NUM_ROWS  11
+#define TILESET_NUM_COLS  12
+
+struct BenchmarkSimulation
+{
+	ITU_EntityId* sprite_ids;
+	int           tick;
+};
+
+struct BenchmarkStats
+{
+	SDL_Time elapsed_update;
+	SDL_Time elapsed_systems;
+	SDL_Time elapsed_particles;
+	SDL_Time elapsed_debug_draw;
+	SDL_Time elapsed_present;
+};
+
+static void benchmark_scene_init(SDLContext* context, ITU_EntityId* sprite_ids)
+{
+	ITU_IdTexture tileset_id = itu_sys_rstorage_texture_load(context, "data/kenney/tiny_dungeon_packed.png", SDL_SCALEMODE_NEAREST);
+	SDL_Texture*  tileset    = itu_sys_rstorage_texture_get_ptr(tileset_id);
+
+	// tilemap
+	{
+		Tilemap tilemap;
+		itu_lib_tilemap_init(&tilemap, tileset, TILESET_NUM_COLS, TILESET_TILE_SIZE, BENCHMARK_TILEMAP_SIZE, BENCHMARK_TILEMAP_SIZE);
+		for(int y = 0; y < BENCHMARK_TILEMAP_SIZE; ++y)
+			for(int x = 0; x < BENCHMARK_TILEMAP_SIZE; ++x)
+				itu_lib_tilemap_set_tile(&tilemap, x, y, (x * 7 + y * 13) % (TILESET_NUM_ROWS * TILESET_NUM_COLS));
+		tilemap.layer = -1;
+
+		Transform transform = TRANSFORM_DEFAULT;
+		ITU_EntityId id = itu_entity_create();
+		entity_add_component(id, Transform, transform);
+		entity_add_component(id, Tilemap, tilemap);
+
+		// bake everything upfront, chunks can't be baked by the simulation thread
+		itu_lib_tilemap_bake_all(context, entity_get_data(id, Tilemap));
+	}
+
+	// sprites, on a grid around the origin
+	const int grid_size = 64;
+	for(int i = 0; i < BENCHMARK_SPRITES_COUNT; ++i)
+	{
+		Transform transform = TRANSFORM_DEFAULT;
+		transform.position.x = (i % grid_size) - grid_size / 2;
+		transform.position.y = (i / grid_size) - grid_size / 2;
+
+		Sprite sprite;
+		itu_lib_sprite_init(&sprite, tileset, itu_lib_sprite_get_rect(i % TILESET_NUM_COLS, 7 + (i / TILESET_NUM_COLS) % 4, TILESET_TILE_SIZE, TILESET_TILE_SIZE));
+
+		ITU_EntityId id = itu_entity_create();
+		entity_add_component(id, Transform, transform);
+		entity_add_component(id, Sprite, sprite);
+		sprite_ids[i] = id;
+	}
+
+	// particle emitters on a ring, all sharing the same texture (ie, one draw call for all of them)
+	for(int i = 0; i < BENCHMARK_EMITTERS_COUNT; ++i)
+	{
+		ITU_ParticleEmitterDesc desc = itu_sys_particles_emitter_desc_default(tileset, itu_lib_sprite_get_rect(0, 10, TILESET_TILE_SIZE, TILESET_TILE_SIZE));
+		desc.blend_mode = SDL_BLENDMODE_ADD;
+		desc.particles_max = BENCHMARK_PARTICLES_PER_EMITTER;
+		desc.life_min = 1.5f;
+		desc.life_max = 2.0f;
+		desc.spawn_rate = BENCHMARK_PARTICLES_PER_EMITTER / desc.life_max;
+		desc.direction_spread = 2 * PI;
+		desc.speed_min = 1;
+		desc.speed_max = 6;
+		desc.gravity = vec2f { 0, -2 };
+		desc.drag = 0.5f;
+		desc.color_start = COLOR_YELLOW;
+		desc.color_end = color { 1.0f, 0.0f, 0.0f, 0.0f };
+		desc.color_easing = EASING_IN_QUAD;
+		desc.size_start = 0.3f;
+		desc.size_end = 0.05f;
+		desc.size_easing = EASING_OUT_CUBIC;
+
+		float angle = 2 * PI * i / BENCHMARK_EMITTERS_COUNT;
+		itu_sys_particles_emitter_create(&desc, vec2f { SDL_cosf(angle) * 16, SDL_sinf(angle) * 16 });
+	}
+}
+
+static void benchmark_scene_update(SDLContext* context, ITU_EntityId* sprite_ids, int frame)
+{
+	float t = frame * PHYSICS_TIMESTEP_SECS;
+
+	// camera pans and zooms, so that culling and chunk visibility change over time
+	context->camera_active->world_position = vec2f { SDL_cosf(t * 0.5f) * 24, SDL_sinf(t * 0.3f) * 24 };
+	context->camera_active->zoom = 1.0f + 0.5f * SDL_sinf(t * 0.2f);
+
+	for(int i = 0; i < BENCHMARK_SPRITES_COUNT; ++i)
+	{
+		Transform* transform = entity_get_data(sprite_ids[i], Transform);
+		transform->rotation = t + i;
+	}
+}
+
+// simulation thread update, same work as the single-threaded loop minus rendering
+static void benchmark_simulation_update(SDLContext* context, void* user_data)
+{
+	BenchmarkSimulation* simulation = (BenchmarkSimulation*)user_data;
+
+	benchmark_scene_update(context, simulation->sprite_ids, simulation->tick++);
+	itu_sys_estorage_systems_update(context);
+}
+
+int main(int argc, char** argv)
+{
+	int frames_count = argc > 1 ? SDL_max(SDL_atoi(argv[1]), 1) : BENCHMARK_FRAMES_DEFAULT;
+	int w            = argc > 2 ? SDL_atoi(argv[2]) : WINDOW_W;
+	int h            = argc > 3 ? SDL_atoi(argv[3]) : WINDOW_H;
+	int workers      = argc > 4 ? SDL_atoi(argv[4]) : ITU_JOBS_WORKERS_AUTO;
+	bool threaded    = argc > 5 ? SDL_atoi(argv[5]) != 0 : false;
+
+	SDLContext context = { 0 };
+	if(!sdl_context_init_headless(&context, w, h))
+		return 1;
+
+	context.working_dir = SDL_GetCurrentDirectory();
+	context.camera_default.normalized_screen_size.x = 1.0f;
+	context.camera_default.normalized_screen_size.y = 1.0f;
+	context.camera_default.zoom = 1;
+	context.camera_default.pixels_per_unit = CAMERA_PIXELS_PER_UNIT;
+	camera_set_active(&context, &context.camera_default);
+
+	itu_sys_jobs_init(workers);
+	itu_sys_renderstats_set_enabled(true);
+	itu_sys_estorage_init(BENCHMARK_SPRITES_COUNT + 1);
+	itu_sys_physics_init(&context, true);
+	b2WorldDef world_def = b2DefaultWorldDef();
+	itu_sys_physics_reset(&world_def);
+
+	ITU_EntityId* sprite_ids = (ITU_EntityId*)SDL_malloc(BENCHMARK_SPRITES_COUNT * sizeof(ITU_EntityId));
+	benchmark_scene_init(&context, sprite_ids);
+
+	SDL_Log(
+		"render benchmark: %d frames, %dx%d, %d sprites, %dx%d tilemap, %d threads%s",
+		frames_count, w, h, BENCHMARK_SPRITES_COUNT, BENCHMARK_TILEMAP_SIZE, BENCHMARK_TILEMAP_SIZE, itu_sys_jobs_get_threads_count(),
+		threaded ? ", simulation thread" : ""
+	);
+
+	BenchmarkSimulation simulation = { sprite_ids, 0 };
+	if(threaded && !itu_sys_simthread_start(&context, PHYSICS_TIMESTEP_NSECS, benchmark_simulation_update, &simulation))
+		threaded = false;
+
+	BenchmarkStats stats = { 0 };
+	SDL_Time walltime_beg;
+	SDL_Time walltime_end;
+	SDL_Time walltime_stage;
+	SDL_GetCurrentTime(&walltime_beg);
+
+	for(int frame = 0; frame < frames_count; ++frame)
+	{
+		// fixed delta, so that every run renders exactly the same frames
+		context.elapsed_frame = PHYSICS_TIMESTEP_NSECS;
+		context.delta = PHYSICS_TIMESTEP_SECS;
+		context.uptime += context.delta;
+
+		SDL_SetRenderDrawColor(context.renderer, 0x00, 0x00, 0x00, 0xFF);
+		SDL_RenderClear(context.renderer);
+		itu_sys_renderstats_frame_begin(&context);
+
+		SDL_Time walltime_frame;
+		SDL_GetCurrentTime(&walltime_frame);
+
+		if(threaded)
+		{
+			// simulation (update + systems) happens on the other thread, "systems" here is only drawing the snapshot
+			itu_sys_renderstats_scope_begin("snapshot");
+			itu_sys_render_snapshot_render(&context);
+			itu_sys_renderstats_scope_end();
+			SDL_GetCurrentTime(&walltime_stage);
+			stats.elapsed_systems += walltime_stage - walltime_frame;
+			walltime_frame = walltime_stage;
+		}
+		else
+		{
+			benchmark_scene_update(&context, sprite_ids, frame);
+			SDL_GetCurrentTime(&walltime_stage);
+			stats.elapsed_update += walltime_stage - walltime_frame;
+			walltime_frame = walltime_stage;
+
+			itu_sys_estorage_systems_update(&context);
+			SDL_GetCurrentTime(&walltime_stage);
+			stats.elapsed_systems += walltime_stage - walltime_frame;
+			walltime_frame = walltime_stage;
+
+			// NOTE: entities belong to the simulation thread in threaded mode, so per-sprite debug draw is single-threaded only
+			for(int i = 0; i < BENCHMARK_SPRITES_COUNT; ++i)
+			{
+				Transform* transform = entity_get_data(sprite_ids[i], Transform);
+				itu_lib_render_queue_world_circle(&context, transform->position, 0.5f, 12, COLOR_GREEN);
+			}
+		}
+		// particles are not part of the ECS, so they are updated and drawn by this thread in both modes
+		itu_sys_particles_update(PHYSICS_TIMESTEP_SECS);
+		itu_sys_renderstats_scope_begin("particles");
+		itu_sys_particles_render(&context);
+		itu_sys_renderstats_scope_end();
+		SDL_GetCurrentTime(&walltime_stage);
+		stats.elapsed_particles += walltime_stage - walltime_frame;
+		walltime_frame = walltime_stage;
+
+		itu_lib_render_draw_world_grid(&context);
+		itu_lib_render_queue_flush(context.renderer);
+		SDL_GetCurrentTime(&walltime_stage);
+		stats.elapsed_debug_draw += walltime_stage - walltime_frame;
+		walltime_frame = walltime_stage;
+
+		SDL_RenderPresent(context.renderer);
+		SDL_GetCurrentTime(&walltime_stage);
+		stats.elapsed_present += walltime_stage - walltime_frame;
+	}
+
+	SDL_GetCurrentTime(&walltime_end);
+
+	if(threaded)
+	{
+		itu_sys_simthread_stop();
+		SDL_Log("simulation ticks: %llu", (unsigned long long)itu_sys_simthread_get_ticks_count());
+	}
+
+	Uint32 checksum = sdl_context_framebuffer_checksum(&context);
+
+	SDL_Log("stage timings (average)");
+	SDL_Log("  %-32s %8.3f ms/f", "update",     NS_TO_MILLIS(stats.elapsed_update     / frames_count));
+	SDL_Log("  %-32s %8.3f ms/f", "systems",    NS_TO_MILLIS(stats.elapsed_systems    / frames_count));
+	itu_sys_estorage_log_timings(frames_count);
+	SDL_Log("  %-32s %8.3f ms/f", "particles",  NS_TO_MILLIS(stats.elapsed_particles  / frames_count));
+	SDL_Log("  %-32s %8.3f ms/f", "debug draw", NS_TO_MILLIS(stats.elapsed_debug_draw / frames_count));
+	SDL_Log("  %-32s %8.3f ms/f", "present",    NS_TO_MILLIS(stats.elapsed_present    / frames_count));
+	SDL_Log("  %-32s %8.3f ms/f", "total",      NS_TO_MILLIS((walltime_end - walltime_beg) / frames_count));
+	SDL_Log("live particles: %d", itu_sys_particles_get_live_count());
+	itu_sys_renderstats_log();
+	SDL_Log("framebuffer checksum: %08x", checksum);
+
+	SDL_free(sprite_ids);
+	itu_sys_particles_clear();
+	itu_sys_jobs_shutdown();
+	itu_sys_physics_shutdown();
+	SDL_DestroyRenderer(context.renderer);
+	SDL_DestroySurface(context.headless_surface);
+	SDL_Quit();
+
+	return 0;
+}
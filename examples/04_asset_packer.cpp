@@ -0,0 +1,225 @@
+/* 04_asset_packer.cpp
+ *
+ * Offline asset packer: converts a data folder (recursively) into a single asset pack (see `itu_lib_assetpack.hpp`).
+ * Images readable by stb_image are decoded and stored as RGBA32 pixels, all other files are stored as-is.
+ * Images that a 16 bit format stores exactly (ie, pixel art with a small palette) are stored in that format instead, halving
+ * their size in the pack and, if the game allows it (see `itu_sys_rstorage_texture_set_quality`), in texture memory.
+ * At runtime the pack is mounted with `itu_sys_rstorage_pack_mount`, and the resource storage loads from it instead of
+ * opening and decoding single files.
+ *
+ * the `asset_pack` build target runs this on the build directory copy of `data`
+ *
+ * usage: 04_asset_packer [input_dir] [output_path]
+ */
+
+#define STB_DS_IMPLEMENTATION
+#define STB_IMAGE_IMPLEMENTATION
+#define ITU_LIB_ASSETPACK_IMPLEMENTATION
+
+#include <SDL3/SDL.h>
+#include <stb_ds.h>
+#include <stb_image.h>
+
+#include <itu_common.hpp>
+#include <itu_lib_fileutils.hpp>
+#include <itu_lib_assetpack.hpp>
+
+#define PACKER_INPUT_DIR_DEFAULT   "data"
+#define PACKER_OUTPUT_PATH_DEFAULT "data/assets.itupack"
+
+struct PackerFile
+{
+	char*              path; // as found on disk
+	ITU_AssetPackEntry entry;
+};
+
+struct PackerState
+{
+	stbds_arr(PackerFile) files;
+	char output_path_normalized[ITU_ASSETPACK_PATH_MAX];
+};
+
+static SDL_EnumerationResult SDLCALL packer_enumerate_callback(void* userdata, const char* dirname, const char* fname)
+{
+	PackerState* state = (PackerState*)userdata;
+
+	// NOTE: `dirname` already ends with a separator
+	char path[1024];
+	SDL_snprintf(path, sizeof(path), "%s%s", dirname, fname);
+
+	SDL_PathInfo path_info;
+	if(!SDL_GetPathInfo(path, &path_info))
+		return SDL_ENUM_CONTINUE;
+
+	if(path_info.type == SDL_PATHTYPE_DIRECTORY)
+		return SDL_EnumerateDirectory(path, packer_enumerate_callback, state) ? SDL_ENUM_CONTINUE : SDL_ENUM_FAILURE;
+
+	if(path_info.type != SDL_PATHTYPE_FILE)
+		return SDL_ENUM_CONTINUE;
+
+	PackerFile file = { 0 };
+	itu_lib_fileutils_normalize_path(path, file.entry.path, ITU_ASSETPACK_PATH_MAX);
+	if(SDL_strlen(file.entry.path) >= ITU_ASSETPACK_PATH_MAX - 1)
+	{
+		SDL_Log("WARNING skipping '%s', path too long", path);
+		return SDL_ENUM_CONTINUE;
+	}
+
+	// don't pack the previous pack
+	if(SDL_strcmp(file.entry.path, state->output_path_normalized) == 0)
+		return SDL_ENUM_CONTINUE;
+
+	int w, h, n;
+	if(stbi_info(path, &w, &h, &n))
+	{
+		// NOTE: the format depends on the content, so images are decoded here too (and again when writing, to keep
+		//       memory usage to one image at a time)
+		Uint8* pixels = stbi_load(path, &w, &h, &n, 4);
+		file.entry.type = ITU_ASSETPACK_ENTRY_TYPE_IMAGE;
+		file.entry.format = pixels ? itu_lib_assetpack_image_compact_format(pixels, w, h, false) : SDL_PIXELFORMAT_RGBA32;
+		file.entry.w = w;
+		file.entry.h = h;
+		file.entry.size = (Uint64)w * h * SDL_BYTESPERPIXEL((SDL_PixelFormat)file.entry.format);
+		stbi_image_free(pixels);
+	}
+	else
+	{
+		file.entry.type = ITU_ASSETPACK_ENTRY_TYPE_RAW;
+		file.entry.size = path_info.size;
+	}
+
+	file.path = SDL_strdup(path);
+	stbds_arrput(state->files, file);
+
+	return SDL_ENUM_CONTINUE;
+}
+
+static int SDLCALL packer_file_compare(const void* a, const void* b)
+{
+	return SDL_strcmp(((const PackerFile*)a)->entry.path, ((const PackerFile*)b)->entry.path);
+}
+
+static bool packer_write_padding(SDL_IOStream* stream, Uint64* offset)
+{
+	static const Uint8 zeroes[ITU_ASSETPACK_DATA_ALIGNMENT] = { 0 };
+
+	Uint64 padding = (ITU_ASSETPACK_DATA_ALIGNMENT - *offset % ITU_ASSETPACK_DATA_ALIGNMENT) % ITU_ASSETPACK_DATA_ALIGNMENT;
+	*offset += padding;
+
+	return SDL_WriteIO(stream, zeroes, (size_t)padding) == padding;
+}
+
+int main(int argc, char** argv)
+{
+	const char* input_dir   = argc > 1 ? argv[1] : PACKER_INPUT_DIR_DEFAULT;
+	const char* output_path = argc > 2 ? argv[2] : PACKER_OUTPUT_PATH_DEFAULT;
+
+	SDL_Time time_beg = SDL_GetTicksNS();
+
+	PackerState state = { 0 };
+	itu_lib_fileutils_normalize_path(output_path, state.output_path_normalized, ITU_ASSETPACK_PATH_MAX);
+
+	// 1. collect files and compute the layout (only image headers are read)
+	if(!SDL_EnumerateDirectory(input_dir, packer_enumerate_callback, &state))
+	{
+		SDL_Log("ERROR reading '%s': %s", input_dir, SDL_GetError());
+		return 1;
+	}
+
+	int files_count = stbds_arrlen(state.files);
+	SDL_qsort(state.files, files_count, sizeof(PackerFile), packer_file_compare);
+
+	Uint64 offset = sizeof(ITU_AssetPackHeader) + files_count * sizeof(ITU_AssetPackEntry);
+	for(int i = 0; i < files_count; ++i)
+	{
+		offset += (ITU_ASSETPACK_DATA_ALIGNMENT - offset % ITU_ASSETPACK_DATA_ALIGNMENT) % ITU_ASSETPACK_DATA_ALIGNMENT;
+		state.files[i].entry.offset = offset;
+		offset += state.files[i].entry.size;
+	}
+
+	// 2. write header and table of contents, then decode and write data in the same order
+	SDL_IOStream* stream = SDL_IOFromFile(output_path, "wb");
+	if(!stream)
+	{
+		SDL_Log("ERROR opening '%s': %s", output_path, SDL_GetError());
+		return 1;
+	}
+
+	ITU_AssetPackHeader header = { 0 };
+	header.magic = ITU_ASSETPACK_MAGIC;
+	header.version = ITU_ASSETPACK_VERSION;
+	header.entries_count = files_count;
+
+	bool ok = SDL_WriteIO(stream, &header, sizeof(header)) == sizeof(header);
+	for(int i = 0; i < files_count && ok; ++i)
+		ok = SDL_WriteIO(stream, &state.files[i].entry, sizeof(ITU_AssetPackEntry)) == sizeof(ITU_AssetPackEntry);
+
+	int images_count = 0;
+	int images_compact_count = 0;
+	Uint64 offset_curr = sizeof(ITU_AssetPackHeader) + files_count * sizeof(ITU_AssetPackEntry);
+	for(int i = 0; i < files_count && ok; ++i)
+	{
+		PackerFile* file = &state.files[i];
+		ok = packer_write_padding(stream, &offset_curr);
+		SDL_assert(!ok || offset_curr == file->entry.offset);
+
+		void* data = NULL;
+		if(file->entry.type == ITU_ASSETPACK_ENTRY_TYPE_IMAGE)
+		{
+			int w, h, n;
+			data = stbi_load(file->path, &w, &h, &n, 4);
+			if(!data || (Uint32)w != file->entry.w || (Uint32)h != file->entry.h)
+			{
+				SDL_Log("ERROR decoding '%s'", file->path);
+				ok = false;
+			}
+			else if(file->entry.format != SDL_PIXELFORMAT_RGBA32)
+			{
+				void* data_compact = SDL_malloc((size_t)file->entry.size);
+				ok = SDL_ConvertPixels(w, h, SDL_PIXELFORMAT_RGBA32, data, w * 4, (SDL_PixelFormat)file->entry.format, data_compact, w * 2);
+				stbi_image_free(data);
+				data = data_compact;
+				++images_compact_count;
+			}
+			++images_count;
+		}
+		else
+		{
+			size_t size;
+			data = SDL_LoadFile(file->path, &size);
+			if(!data || size != file->entry.size)
+			{
+				SDL_Log("ERROR reading '%s' (file changed while packing?)", file->path);
+				ok = false;
+			}
+		}
+
+		if(ok)
+			ok = SDL_WriteIO(stream, data, (size_t)file->entry.size) == file->entry.size;
+		offset_curr += file->entry.size;
+
+		if(file->entry.type == ITU_ASSETPACK_ENTRY_TYPE_IMAGE && file->entry.format == SDL_PIXELFORMAT_RGBA32)
+			stbi_image_free(data);
+		else
+			SDL_free(data);
+	}
+
+	ok &= SDL_CloseIO(stream);
+	if(!ok)
+	{
+		SDL_Log("ERROR writing '%s': %s", output_path, SDL_GetError());
+		SDL_RemovePath(output_path);
+		return 1;
+	}
+
+	SDL_Log(
+		"packed %d files (%d images, %d in 16 bit formats) from '%s' in '%s', %.2f MB, %.0f ms",
+		files_count, images_count, images_compact_count, input_dir, output_path, offset / (1024.0 * 1024.0), NS_TO_MILLIS(SDL_GetTicksNS() - time_beg)
+	);
+
+	for(int i = 0; i < files_count; ++i)
+		SDL_free(state.files[i].path);
+	stbds_arrfree(state.files);
+
+	return 0;
+}
@@ -210,7 +210,7 @@ static void game_init(SDLContext* context, GameState* state)
 	state->atlas_character = texture_create(context, "data/kenney/character_femalePerson_sheet.png", SDL_SCALEMODE_LINEAR);
 	state->atlas_tiles     = texture_create(context, "data/kenney/spritesheet-tiles-default.png", SDL_SCALEMODE_LINEAR);
 
-	itu_sys_physics_init(context);
+	itu_sys_physics_init(context, false);
 
 	// TEST to see if audio is working
 	MIX_Mixer* mixer;
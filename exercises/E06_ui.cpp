@@ -391,7 +391,7 @@ static void game_init(SDLContext* context, GameState* state)
 	state->ui_imagebutton_depth = texture_create(context, "data/kenney/UI/button_rectangle_depth.png", SDL_SCALEMODE_LINEAR);
 
 	itu_sys_estorage_init(512);
-	itu_sys_physics_init(context);
+	itu_sys_physics_init(context, false);
 
 	enable_component(EX6_PlayerData);
 	enable_component(EX6_Health);
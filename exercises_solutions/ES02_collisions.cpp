@@ -591,9 +591,8 @@ static void game_render(MySDLContext* context, GameState* state)
 
 		if(DEBUG_render_colliders)
 		{
-			itu_lib_render_draw_point(context->renderer, entity->position + entity->collider_offset, 5, COLOR_GREEN);
-			itu_lib_render_draw_circle(
-				context->renderer,
+			itu_lib_render_queue_point(entity->position + entity->collider_offset, 5, COLOR_GREEN);
+			itu_lib_render_queue_circle(
 				entity->position + entity->collider_offset,
 				entity->collider_radius,
 				16, COLOR_GREEN
@@ -601,6 +600,9 @@ static void game_render(MySDLContext* context, GameState* state)
 		}
 	}
 
+	// colliders are queued above, submit them all at once
+	itu_lib_render_queue_flush(context->renderer);
+
 	// debug world partition
 	{
 		world_partition_debug_cells(context, state);
@@ -219,10 +219,25 @@ static void game_render(SDLContext* context, GameState* state)
 		vec2f player_min_tilemap = tilemap_point_world_to_tilemap(tilemap, state->player->transform.position - mul_element_wise(player_size_world, state->player->sprite.pivot));
 		vec2f player_max_tilemap = tilemap_point_world_to_tilemap(tilemap, state->player->transform.position + mul_element_wise(player_size_world, one_minus_pivot));
 
+		// clip to the range of tiles visible by the camera, so that we don't submit offscreen tiles
+		// (tile (x, y) covers world x from `position.x + tile_w * (x - 0.5)` to `position.x + tile_w * (x + 0.5)`, same for y)
+		SDL_FRect rect_view = camera_get_world_rect(context, context->camera_active);
+		vec2f tile_size_world;
+		tile_size_world.x = tilemap->transform.scale.x * (tilemap->tile_size / (float)TEXTURE_PIXELS_PER_UNIT);
+		tile_size_world.y = tilemap->transform.scale.y * (tilemap->tile_size / (float)TEXTURE_PIXELS_PER_UNIT);
+		int x_beg = (int)SDL_floorf((rect_view.x               - tilemap->transform.position.x) / tile_size_world.x - tile_offset);
+		int y_beg = (int)SDL_floorf((rect_view.y               - tilemap->transform.position.y) / tile_size_world.y - tile_offset);
+		int x_end = (int)SDL_floorf((rect_view.x + rect_view.w - tilemap->transform.position.x) / tile_size_world.x - tile_offset) + 1;
+		int y_end = (int)SDL_floorf((rect_view.y + rect_view.h - tilemap->transform.position.y) / tile_size_world.y - tile_offset) + 1;
+		x_beg = SDL_max(x_beg, 0);
+		y_beg = SDL_max(y_beg, 0);
+		x_end = SDL_min(x_end, tilemap->num_cols);
+		y_end = SDL_min(y_end, tilemap->num_rows);
+
 		// we could hve each tile being an independent entity, be let's do something more clever
-		for(int y = 0; y < tilemap->num_rows; ++y)
+		for(int y = y_beg; y < y_end; ++y)
 		{
-			for(int x = 0; x < tilemap->num_cols; ++x)
+			for(int x = x_beg; x < x_end; ++x)
 			{
 				// get tile coords from tile id in the map and tile-id mapping
 				int tile_id_map = tilemap->tile_ids[y * tilemap->num_cols + x];
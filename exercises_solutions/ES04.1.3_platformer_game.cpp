@@ -32,6 +32,10 @@
 #define WINDOW_W         800
 #define WINDOW_H         600
 
+// low-res pixel-art target (half the window, upscaled x2, with texture pixels mapped 1:1 on target pixels)
+#define LOWRES_W         400
+#define LOWRES_H         300
+
 #define ENTITY_COUNT   1024
 #define PLATFORM_COUNT   32
 
@@ -49,6 +53,7 @@ enum CollisionType
 bool DEBUG_render_textures = true;
 bool DEBUG_render_outlines = false;
 bool DEBUG_physics = true;
+bool DEBUG_render_lowres = true;
 int DEBUG_collision_type = COLLISION_TYPE_CONTINOUS;
 
 b2DebugDraw debug_draw;
@@ -787,6 +792,7 @@ int main(void)
 
 	camera_set_active(&context, &context.camera_default);
 
+	itu_sys_lowres_init(&context, LOWRES_W, LOWRES_H);
 
 	game_init(&context, &state);
 	game_reset(&context, &state);
@@ -850,6 +856,7 @@ int main(void)
 							case SDLK_F1: DEBUG_render_textures = !DEBUG_render_textures; break;
 							case SDLK_F2: DEBUG_render_outlines = !DEBUG_render_outlines; break;
 							case SDLK_F3: DEBUG_physics = !DEBUG_physics; break;
+							case SDLK_F4: DEBUG_render_lowres = !DEBUG_render_lowres; break;
 						}
 					}
 					break;
@@ -893,7 +900,12 @@ int main(void)
 		SDL_Log("UPDATE POST\n");
 		game_update_post_physics(&context, &state);
 
+		// world is rendered in the low-res target, ImGui stays at native resolution
+		context.camera_default.pixels_per_unit = DEBUG_render_lowres ? TEXTURE_PIXELS_PER_UNIT : CAMERA_PIXELS_PER_UNIT;
+		if(DEBUG_render_lowres)
+			itu_sys_lowres_begin(&context);
 		game_render(&context, &state);
+		itu_sys_lowres_end(&context);
 
 #ifdef ENABLE_DIAGNOSTICS
 		// NOTE: moving the diagnostic rendering here means that we are effectively showing information about the previous frame.
@@ -915,6 +927,7 @@ int main(void)
 			ImGui::Checkbox("[F1] render textures", &DEBUG_render_textures);
 			ImGui::Checkbox("[F2] render outlines", &DEBUG_render_outlines);
 			ImGui::Checkbox("[F3] render physics", &DEBUG_physics);
+			ImGui::Checkbox("[F4] render low-res", &DEBUG_render_lowres);
 			ImGui::PopItemWidth();
 			ImGui::End();
 		}
@@ -130,6 +130,9 @@ static void game_init(SDLContext* context, GameState* state)
 	SDL_assert(state->entities);
 
 	state->world_id = { 0 };
+
+	// box2d splits the step on the job system threads (see `game_reset`)
+	itu_sys_jobs_init(ITU_JOBS_WORKERS_AUTO);
 	
 	state->player_data = { 0 };
 	state->player_data.g = -66.67f;
@@ -150,6 +153,7 @@ static void game_reset(SDLContext* context, GameState* state)
 		b2DestroyWorld(state->world_id);
 	b2WorldDef def_world = b2DefaultWorldDef();
 	def_world.gravity.y = GRAVITY;
+	itu_sys_physics_world_def_set_jobs(&def_world);
 	state->world_id = b2CreateWorld(&def_world);
 
 	state->entities_alive_count = 0;
@@ -594,4 +598,8 @@ int main(void)
 		accumulator_physics += elapsed_frame;
 		walltime_frame_beg = walltime_frame_end;
 	}
+
+	// no box2d task can be running outside of a step, workers can go before the world
+	itu_sys_jobs_shutdown();
+	b2DestroyWorld(state.world_id);
 }
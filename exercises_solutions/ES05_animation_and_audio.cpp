@@ -76,6 +76,22 @@ struct PlayerData
 	float g;   // gravity
 };
 
+// sprite sheet regions used when spawning, resolved once in `game_init` (see `itu_lib_spritesheet_find_region`)
+struct PlayerRegions
+{
+	int idle;
+	int think;
+	int walk[8];
+	int jump;
+	int fall;
+};
+
+struct DoorRegions
+{
+	int top;
+	int bottom;
+};
+
 const char* animations[] = 
 {
 	"idle",
@@ -121,6 +137,12 @@ struct GameState
 	SDL_Texture* atlas_character;
 	SDL_Texture* atlas_tiles;
 
+	// named regions of the atlases above
+	ITU_SpriteSheet sheet_character;
+	ITU_SpriteSheet sheet_tiles;
+	PlayerRegions   player_regions;
+	DoorRegions     door_regions;
+
 	// audio data
 	float volume_music;
 	float volume_sfx;
@@ -276,11 +298,15 @@ static void game_init(SDLContext* context, GameState* state)
 	state->entities = (Entity*)SDL_calloc(ENTITY_COUNT, sizeof(Entity));
 	SDL_assert(state->entities);
 	
-	// texture atlases
-	state->atlas_character = texture_create(context, "data/kenney/character_femalePerson_sheet.png", SDL_SCALEMODE_LINEAR);
-	state->atlas_tiles     = texture_create(context, "data/kenney/spritesheet-tiles-default.png", SDL_SCALEMODE_LINEAR);
+	// texture atlases, with their regions imported from the XML that comes with them
+	itu_lib_spritesheet_load(&state->sheet_character, "data/kenney/character_femalePerson_sheet.xml");
+	itu_lib_spritesheet_load(&state->sheet_tiles,     "data/kenney/spritesheet-tiles-default.xml");
+	state->atlas_character = texture_create(context, itu_lib_spritesheet_get_image_path(&state->sheet_character), SDL_SCALEMODE_LINEAR);
+	state->atlas_tiles     = texture_create(context, itu_lib_spritesheet_get_image_path(&state->sheet_tiles), SDL_SCALEMODE_LINEAR);
+	player_regions_resolve(&state->player_regions, &state->sheet_character);
+	door_regions_resolve(&state->door_regions, &state->sheet_tiles);
 
-	itu_sys_physics_init(context);
+	itu_sys_physics_init(context, false);
 
 	sys_audio_init(4);
 	
@@ -291,10 +317,12 @@ static void game_init(SDLContext* context, GameState* state)
 		// 2. sound effects store the key and use it to interface with the audio system going forward
 		// using strings directly can make sense in certain situations (see L06 when we talk about tools and editors), but they ar epretty slow,
 		// even when hashed. At runtime, games should always use keys (which can be read from file, so usually that's not a problem)
-		sys_audio_load(music_files[0], true);
-		sys_audio_load(music_files[1], true);
-		KEY_SFX_FOOTSTEP = sys_audio_load("data/kenney/SFX/footstep00.ogg", true);
-		KEY_SFX_DOOR     = sys_audio_load("data/kenney/SFX/doorClose_1.ogg", true);
+		// music tracks are long, so they are streamed (fully decoded they would be the biggest chunk of memory we use),
+		// sound effects are short and played often, so they are decoded once
+		sys_audio_load(music_files[0], ITU_AUDIO_LOAD_POLICY_STREAM);
+		sys_audio_load(music_files[1], ITU_AUDIO_LOAD_POLICY_STREAM);
+		KEY_SFX_FOOTSTEP = sys_audio_load("data/kenney/SFX/footstep00.ogg", ITU_AUDIO_LOAD_POLICY_PREDECODE);
+		KEY_SFX_DOOR     = sys_audio_load("data/kenney/SFX/doorClose_1.ogg", ITU_AUDIO_LOAD_POLICY_PREDECODE);
 
 		// arbitrary decision to make audio settings not reset with games
 		// in an actual game those would be stored togheter with savefiles and read form a file,
@@ -326,7 +354,7 @@ static void game_reset(SDLContext* context, GameState* state)
 		b2Filter collision_filter = { 0 };
 		collision_filter.categoryBits = COLLISION_FILTER_PLAYER;
 		collision_filter.maskBits     = COLLISION_FILTER_GROUND | COLLISION_FILTER_SENSOR;
-		player_reset(context, state->player, &state->player_data, &state->player_animation_data, state->atlas_character, collision_filter);
+		player_reset(context, state->player, &state->player_data, &state->player_animation_data, state->atlas_character, &state->sheet_character, &state->player_regions, collision_filter);
 	}
 
 	// terrain
@@ -344,7 +372,7 @@ static void game_reset(SDLContext* context, GameState* state)
 	// door
 	{
 		state->door = entity_create(state);
-		door_reset(state->door, &state->door_data, state->atlas_tiles);
+		door_reset(state->door, &state->door_data, state->atlas_tiles, &state->sheet_tiles, &state->door_regions);
 	}
 }
 
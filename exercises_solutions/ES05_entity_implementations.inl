@@ -7,7 +7,21 @@ void player_compute_jump_parameters(Entity* entity, float* out_vertical_speed, f
 	*out_gravity        = (-2 * h * v_x*v_x) / (x_h*x_h);
 }
 
-void player_reset(SDLContext* context, Entity* entity, PlayerData* player_data, AnimationData* animation_data, SDL_Texture* texture, b2Filter collision_filter)
+void player_regions_resolve(PlayerRegions* regions, ITU_SpriteSheet* sheet)
+{
+	regions->idle  = itu_lib_spritesheet_find_region(sheet, "idle");
+	regions->think = itu_lib_spritesheet_find_region(sheet, "think");
+	regions->jump  = itu_lib_spritesheet_find_region(sheet, "jump");
+	regions->fall  = itu_lib_spritesheet_find_region(sheet, "fall");
+	for(int i = 0; i < (int)SDL_arraysize(regions->walk); ++i)
+	{
+		char frame_name[16];
+		SDL_snprintf(frame_name, sizeof(frame_name), "walk%d", i);
+		regions->walk[i] = itu_lib_spritesheet_find_region(sheet, frame_name);
+	}
+}
+
+void player_reset(SDLContext* context, Entity* entity, PlayerData* player_data, AnimationData* animation_data, SDL_Texture* texture, ITU_SpriteSheet* sheet, PlayerRegions* regions, b2Filter collision_filter)
 {
 	SDL_memset(player_data, 0, sizeof(PlayerData));
 	player_data->g = -66.67f;
@@ -17,7 +31,7 @@ void player_reset(SDLContext* context, Entity* entity, PlayerData* player_data,
 	itu_lib_sprite_init(
 		&entity->sprite,
 		texture,
-		SDL_FRect { 0, 0, 96, 128 } 
+		itu_lib_spritesheet_get_region_rect(sheet, regions->idle)
 	);
 	entity->sprite.pivot.y = 0;
 
@@ -51,21 +65,21 @@ void player_reset(SDLContext* context, Entity* entity, PlayerData* player_data,
 	// animations
 	{
 		KEY_ANIM_IDLE = sys_animation_add_clip_empty(animation_data, "idle");
-		sys_animation_frame_add(animation_data, KEY_ANIM_IDLE, AnimationFrame{ SDL_FRect {   0,   0, 96, 128 }, 2.0f });
-		sys_animation_frame_add(animation_data, KEY_ANIM_IDLE, AnimationFrame{ SDL_FRect { 288, 384, 96, 128 }, 0.5f });
+		sys_animation_frame_add(animation_data, KEY_ANIM_IDLE, AnimationFrame{ itu_lib_spritesheet_get_region_rect(sheet, regions->idle), 2.0f });
+		sys_animation_frame_add(animation_data, KEY_ANIM_IDLE, AnimationFrame{ itu_lib_spritesheet_get_region_rect(sheet, regions->think), 0.5f });
 			
 		// walk
 		KEY_ANIM_WALK = sys_animation_add_clip_empty(animation_data, "walk");
-		for(int i = 0; i < 8; ++i)
-			sys_animation_frame_add(animation_data, KEY_ANIM_WALK, AnimationFrame{ SDL_FRect { i * 96.0f, 512, 96, 128 }, 16.0f / design_player_hor_accel_groud });
+		for(int i = 0; i < (int)SDL_arraysize(regions->walk); ++i)
+			sys_animation_frame_add(animation_data, KEY_ANIM_WALK, AnimationFrame{ itu_lib_spritesheet_get_region_rect(sheet, regions->walk[i]), 16.0f / design_player_hor_accel_groud });
 
 		// jump
 		KEY_ANIM_JUMP = sys_animation_add_clip_empty(animation_data, "jump");
-		sys_animation_frame_add(animation_data, KEY_ANIM_JUMP, AnimationFrame{ SDL_FRect { 86, 0, 96, 128 }, 0.0f });
+		sys_animation_frame_add(animation_data, KEY_ANIM_JUMP, AnimationFrame{ itu_lib_spritesheet_get_region_rect(sheet, regions->jump), 0.0f });
 			
 		// fall
 		KEY_ANIM_FALL = sys_animation_add_clip_empty(animation_data, "fall");
-		sys_animation_frame_add(animation_data, KEY_ANIM_FALL, AnimationFrame{ SDL_FRect { 192, 0, 96, 128 }, 0.0f });
+		sys_animation_frame_add(animation_data, KEY_ANIM_FALL, AnimationFrame{ itu_lib_spritesheet_get_region_rect(sheet, regions->fall), 0.0f });
 	}
 }
 
@@ -234,7 +248,13 @@ void player_handle_collisions(SDLContext* context, Entity* entity, PlayerData* p
 	}
 }
 
-void door_reset(Entity* entity, DoorData* data, SDL_Texture* texture)
+void door_regions_resolve(DoorRegions* regions, ITU_SpriteSheet* sheet)
+{
+	regions->top    = itu_lib_spritesheet_find_region(sheet, "terrain_stone_vertical_top");
+	regions->bottom = itu_lib_spritesheet_find_region(sheet, "terrain_stone_vertical_bottom");
+}
+
+void door_reset(Entity* entity, DoorData* data, SDL_Texture* texture, ITU_SpriteSheet* sheet, DoorRegions* regions)
 {
 	entity->transform.position.x = 7;
 	entity->transform.position.y = 1.5;
@@ -267,9 +287,12 @@ void door_reset(Entity* entity, DoorData* data, SDL_Texture* texture)
 	b2CreatePolygonShape(entity->physics_data.body_id, &shape_def_collision, &polygon_collision);
 	b2CreatePolygonShape(entity->physics_data.body_id, &shape_def_sensor, &polygon_sensor);
 
+	// the door is a 3 tiles tall column, from the top tile to the bottom one (they are stacked in the sheet)
+	SDL_FRect rect_top    = itu_lib_spritesheet_get_region_rect(sheet, regions->top);
+	SDL_FRect rect_bottom = itu_lib_spritesheet_get_region_rect(sheet, regions->bottom);
 	itu_lib_sprite_init(
 		&entity->sprite,
 		texture,
-		SDL_FRect { 0, 64*9, 64, 64*3 } 
+		SDL_FRect { rect_top.x, rect_top.y, rect_top.w, rect_bottom.y + rect_bottom.h - rect_top.y }
 	);
 }
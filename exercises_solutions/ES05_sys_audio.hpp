@@ -8,6 +8,7 @@
 #include <SDL3_mixer/SDL_mixer.h>
 #include <stb_ds.h>
 #include <itu_common.hpp>
+#include <itu_resource_storage.hpp>
 #endif
 
 #define NUM_TRACKS_MAX 32
@@ -29,13 +30,14 @@ struct AudioData
 	float gain_music;
 	float gain_sfx;
 
-	stbds_hm(AudioKey, MIX_Audio*)  audio_files;
+	// clips are owned by the resource storage, this only maps path hashes to their ids
+	stbds_hm(AudioKey, ITU_IdAudio) audio_files;
 };
 
 AudioData sys_audio_data;
 
 void sys_audio_init(int tracks_count);
-AudioKey sys_audio_load(const char* path, bool preload);
+AudioKey sys_audio_load(const char* path, ITU_AudioLoadPolicy policy);
 void sys_audio_play_music(AudioKey key, Sint64 crossfade_duration_ms);
 void sys_audio_play_music_immediate(AudioKey key);
 void sys_audio_play_sfx(AudioKey key);
@@ -78,7 +80,7 @@ MIX_Audio* get_audio(AudioKey key)
 		return NULL;
 	}
 
-	return sys_audio_data.audio_files[loc].value;
+	return itu_sys_rstorage_audio_get_ptr(sys_audio_data.audio_files[loc].value);
 }
 
 void play_audio(int track_idx, MIX_Audio* audio, float gain, SDL_PropertiesID props)
@@ -131,7 +133,7 @@ void sys_audio_init(int tracks_count)
 	sys_audio_data.gain_sfx = 1.0f;
 }
 
-AudioKey sys_audio_load(const char* path, bool preload)
+AudioKey sys_audio_load(const char* path, ITU_AudioLoadPolicy policy)
 {
 	// NOTE: casting from const to non-const is usually a bad idea,
 	//       but in this case we know that `stbds_hash_string` does not modify our pointer so it's fine. 
@@ -143,10 +145,11 @@ AudioKey sys_audio_load(const char* path, bool preload)
 		return key;
 	}
 
-	MIX_Audio* audio;
-	VALIDATE(audio = MIX_LoadAudio(sys_audio_data.mixer, path, preload));
+	ITU_IdAudio id = itu_sys_rstorage_audio_load(sys_audio_data.mixer, path, policy);
+	if(id == ITU_RESOURCE_ID_INVALID)
+		return key;
 
-	stbds_hmput(sys_audio_data.audio_files, key, audio);
+	stbds_hmput(sys_audio_data.audio_files, key, id);
 
 	return key;
 }
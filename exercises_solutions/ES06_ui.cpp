@@ -79,7 +79,10 @@ register_component(EX6_Sprite9Patch)
 
 struct EX6_ImageButton
 {
-	TTF_Text* ttf_text; // owned
+	// text is drawn through `itu_sys_text` (cached layout, batched with all other text)
+	TTF_Font* font;
+	char      text[ITU_TEXT_LENGTH_MAX];
+	color     text_color;
 
 	void (*fn_callback_hover)(SDLContext* context, ITU_EntityId id);
 	void (*fn_callback_click)(SDLContext* context, ITU_EntityId id);
@@ -89,8 +92,6 @@ register_component(EX6_ImageButton)
 
 static ITU_EntityId id_player;
 
-static TTF_TextEngine* ttf_engine;
-
 // ============================================================================================
 // TMP methods
 // ============================================================================================
@@ -164,8 +165,41 @@ void ex6_lib_sprite9patch_render_camera(SDLContext* context, EX6_Sprite9Patch* s
 	);
 }
 
+// UI is drawn in a retained layer (see `itu_sys_uilayer`): this hashes all screen-space components, so that the layer
+// is redrawn only on frames where some of them changed
+void ex6_system_ui_layer_begin(SDLContext* context, ITU_EntityId* entity_ids, int entity_ids_count)
+{
+	for(int i = 0; i < entity_ids_count; ++i)
+	{
+		ITU_EntityId id = entity_ids[i];
+		EX6_TransformScreen* transform   = entity_get_data(id, EX6_TransformScreen);
+		Sprite*              sprite      = entity_get_data(id, Sprite);
+		EX6_Sprite9Patch*    sprite9     = entity_get_data(id, EX6_Sprite9Patch);
+		EX6_ImageButton*     imagebutton = entity_get_data(id, EX6_ImageButton);
+
+		itu_sys_uilayer_hash(&id, sizeof(id));
+		itu_sys_uilayer_hash(transform, sizeof(*transform));
+		if(sprite)
+			itu_sys_uilayer_hash(sprite, sizeof(*sprite));
+		if(sprite9)
+			itu_sys_uilayer_hash(sprite9, sizeof(*sprite9));
+		if(imagebutton)
+			itu_sys_uilayer_hash(imagebutton, sizeof(*imagebutton));
+	}
+
+	itu_sys_uilayer_begin(context);
+}
+
+void ex6_system_ui_layer_end(SDLContext* context, ITU_EntityId* entity_ids, int entity_ids_count)
+{
+	itu_sys_uilayer_end(context);
+}
+
 void ex6_system_sprite_render_camera(SDLContext* context, ITU_EntityId* entity_ids, int entity_ids_count)
 {
+	if(!itu_sys_uilayer_is_redrawing())
+		return;
+
 	for(int i = 0; i < entity_ids_count; ++i)
 	{
 		ITU_EntityId id = entity_ids[i];
@@ -182,6 +216,9 @@ void ex6_system_sprite_render_camera(SDLContext* context, ITU_EntityId* entity_i
 
 void ex6_system_sprite9patch_render_camera(SDLContext* context, ITU_EntityId* entity_ids, int entity_ids_count)
 {
+	if(!itu_sys_uilayer_is_redrawing())
+		return;
+
 	for(int i = 0; i < entity_ids_count; ++i)
 	{
 		ITU_EntityId id = entity_ids[i];
@@ -211,7 +248,8 @@ void ex6_system_imagebutton(SDLContext* context, ITU_EntityId* entity_ids, int e
 		//sdl_set_render_draw_color(context, COLOR_YELLOW);
 		//SDL_RenderRect(context->renderer, &rect_dst);
 
-		TTF_DrawRendererText(imagebutton->ttf_text, rect_dst.x, rect_dst.y);
+		if(itu_sys_uilayer_is_redrawing())
+			itu_sys_text_queue(context, imagebutton->font, imagebutton->text, vec2f { rect_dst.x, rect_dst.y }, VEC2F_ZERO, 1, imagebutton->text_color);
 
 		vec2f mouse_camera_pos = point_window_to_screen(context, context->mouse_pos);
 
@@ -230,6 +268,9 @@ void ex6_system_imagebutton(SDLContext* context, ITU_EntityId* entity_ids, int e
 		else
 			sprite->tint = EX6_COLOR_BTN_DEFAULT;
 	}
+
+	if(itu_sys_uilayer_is_redrawing())
+		itu_sys_text_flush(context);
 }
 
 // ============================================================================================
@@ -303,28 +344,16 @@ void ex6_debug_ui_render_imagebutton(SDLContext* context, void* data)
 	ImGui::LabelText("hover callback", "%p", data_imagebutton->fn_callback_hover);
 	ImGui::LabelText("click callback", "%p", data_imagebutton->fn_callback_click);
 
-	int wrap_width;
-	TTF_GetTextWrapWidth(data_imagebutton->ttf_text, &wrap_width);
-
-	int size[2];
-	TTF_GetTextSize(data_imagebutton->ttf_text, &size[0], &size[1]);
-
-	color c;
-	TTF_GetTextColorFloat(data_imagebutton->ttf_text, &c.r, &c.g, &c.b, &c.a);
-
-	TTF_Font* font = TTF_GetTextFont(data_imagebutton->ttf_text);
 	TTF_Font* new_font;
-	if(itu_sys_rstorage_debug_render_font(font, &new_font))
-		TTF_SetTextFont(data_imagebutton->ttf_text, new_font);
-	
+	if(itu_sys_rstorage_debug_render_font(data_imagebutton->font, &new_font))
+		data_imagebutton->font = new_font;
 
-	ImGui::InputInt2("size (readonly)", size);
+	ImGui::InputText("text", data_imagebutton->text, ITU_TEXT_LENGTH_MAX);
 
-	if(ImGui::DragInt("wrap width", &wrap_width))
-		TTF_SetTextWrapWidth(data_imagebutton->ttf_text, wrap_width);
+	vec2f size = itu_sys_text_measure(context, data_imagebutton->font, data_imagebutton->text);
+	ImGui::InputFloat2("size (readonly)", &size.x, "%.0f", ImGuiInputTextFlags_ReadOnly);
 
-	if(ImGui::ColorEdit4("color", &c.r))
-		TTF_SetTextColorFloat(data_imagebutton->ttf_text, c.r, c.g, c.b, c.a);
+	ImGui::ColorEdit4("color", &data_imagebutton->text_color.r);
 }
 
 // ============================================================================================
@@ -334,9 +363,9 @@ void ex6_debug_ui_render_imagebutton(SDLContext* context, void* data)
 // NOTE: we reached the GameState nirvana (all resources are handled by a dedicated system, more of a "game engine" approach)
 struct GameState
 {
-	// // SDL-allocated structures
-	// SDL_Texture* atlas_space;
-	// SDL_Texture* ui_healtbar;
+	ITU_IdTexture tex_space;
+	ITU_IdTexture tex_healthbar;
+	ITU_IdTexture tex_button;
 };
 
 void ex6_system_assign_player_target(SDLContext* context, ITU_EntityId* entity_ids, int entity_ids_count)
@@ -424,17 +453,42 @@ void ex6_system_health(SDLContext* context, ITU_EntityId* entity_ids, int entity
 
 static void game_init(SDLContext* context, GameState* state)
 {
-	itu_sys_rstorage_texture_load(context, "data/kenney/simpleSpace_tilesheet_2.png", SDL_SCALEMODE_LINEAR);
-	itu_sys_rstorage_texture_load(context, "data/kenney/UI/bar_round_gloss_small_red.png", SDL_SCALEMODE_LINEAR);
-	itu_sys_rstorage_texture_load(context, "data/kenney/UI/panel_square.png", SDL_SCALEMODE_LINEAR);
-	itu_sys_rstorage_font_load(context, "data/ARIAL.TTF", 42);
-	itu_sys_rstorage_font_load(context, "data/ARIALI.TTF", 42);
-	itu_sys_rstorage_font_load(context, "data/ARIALBD.TTF", 42);
-
-	ttf_engine = TTF_CreateRendererTextEngine(context->renderer);
+	// if the asset pack has been built (`asset_pack` target), images come already decoded from it
+	itu_sys_rstorage_pack_mount("data/assets.itupack");
+
+	// small images (the UI ones) share atlas pages, so that they can be batched together
+	itu_sys_rstorage_texture_atlas_enable(1024, 256);
+
+	// the big tilesheet streams in while the game is already running
+	state->tex_space = itu_sys_rstorage_texture_load_async(context, "data/kenney/simpleSpace_tilesheet_2.png", SDL_SCALEMODE_LINEAR);
+
+	// flat UI elements look the same in 16 bit formats, at half the texture memory
+	itu_sys_rstorage_texture_set_quality("data/kenney/UI/bar_round_gloss_small_red.png", ITU_TEXTURE_QUALITY_COMPACT);
+	itu_sys_rstorage_texture_set_quality("data/kenney/UI/panel_square.png", ITU_TEXTURE_QUALITY_COMPACT);
+
+	// everything else is decoded in parallel by the job system workers, while we show a minimal loading bar
+	itu_sys_jobs_init(ITU_JOBS_WORKERS_AUTO);
+	int entry_healthbar = itu_sys_rstorage_manifest_add_texture("data/kenney/UI/bar_round_gloss_small_red.png", SDL_SCALEMODE_LINEAR);
+	int entry_button    = itu_sys_rstorage_manifest_add_texture("data/kenney/UI/panel_square.png", SDL_SCALEMODE_LINEAR);
+	itu_sys_rstorage_manifest_add_font("data/ARIAL.TTF", 42);
+	itu_sys_rstorage_manifest_add_font("data/ARIALI.TTF", 42);
+	itu_sys_rstorage_manifest_add_font("data/ARIALBD.TTF", 42);
+	itu_sys_rstorage_manifest_load(NULL);
+	while(!itu_sys_rstorage_manifest_update(context, MILLIS(8)))
+	{
+		SDL_PumpEvents();
+		SDL_SetRenderDrawColor(context->renderer, 0x00, 0x00, 0x00, 0xFF);
+		SDL_RenderClear(context->renderer);
+		SDL_FRect rect_bar = { context->window_w * 0.25f, context->window_h * 0.5f - 8, context->window_w * 0.5f * itu_sys_rstorage_manifest_get_progress(), 16 };
+		SDL_SetRenderDrawColor(context->renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+		SDL_RenderFillRect(context->renderer, &rect_bar);
+		SDL_RenderPresent(context->renderer);
+	}
+	state->tex_healthbar = itu_sys_rstorage_manifest_get_id(entry_healthbar);
+	state->tex_button    = itu_sys_rstorage_manifest_get_id(entry_button);
 
 	itu_sys_estorage_init(512);
-	itu_sys_physics_init(context);
+	itu_sys_physics_init(context, true);
 
 	enable_component(EX6_PlayerData);
 	enable_component(EX6_Health);
@@ -456,9 +510,11 @@ static void game_init(SDLContext* context, GameState* state)
 	add_system(ex6_system_assign_player_target      , component_mask(Transform), tag_mask(TAG_ASTEROID));
 	add_system(ex6_system_player_update             , component_mask(Transform) | component_mask(PhysicsData) | component_mask(EX6_PlayerData)  , 0);
 	add_system(ex6_system_health                    , component_mask(EX6_HealthRenderer)  | component_mask(EX6_Sprite9Patch), 0);
+	add_system(ex6_system_ui_layer_begin            , component_mask(EX6_TransformScreen)                                   , 0);
 	add_system(ex6_system_sprite_render_camera      , component_mask(EX6_TransformScreen) | component_mask(Sprite)          , 0);
 	add_system(ex6_system_sprite9patch_render_camera, component_mask(EX6_TransformScreen) | component_mask(EX6_Sprite9Patch), 0);
 	add_system(ex6_system_imagebutton               , component_mask(EX6_TransformScreen) | component_mask(EX6_Sprite9Patch) | component_mask(EX6_ImageButton) , 0);
+	add_system(ex6_system_ui_layer_end              , component_mask(EX6_TransformScreen)                                   , 0);
 	add_system(ex6_system_camera_target             , component_mask(Transform), tag_mask(TAG_CAMERA_TARGET));
 }
 
@@ -467,11 +523,8 @@ void TMP_btn_callback_click(SDLContext* context, ITU_EntityId id) { SDL_Log("cli
 
 static void game_reset(SDLContext* context, GameState* state)
 {
-	// TMP get textures pointers
+	// TMP get font pointer
 	//     these should come from a serialized file
-	SDL_Texture* tex_space     = itu_sys_rstorage_texture_get_ptr(0);
-	SDL_Texture* tex_healthbar = itu_sys_rstorage_texture_get_ptr(1);
-	SDL_Texture* tex_button    = itu_sys_rstorage_texture_get_ptr(2);
 	TTF_Font*    font_bold     = itu_sys_rstorage_font_get_ptr(2);
 
 	itu_sys_estorage_clear_all_entities();
@@ -495,7 +548,7 @@ static void game_reset(SDLContext* context, GameState* state)
 		transform.position.y = -7;
 
 		Sprite sprite;
-		itu_lib_sprite_init(&sprite, tex_space, itu_lib_sprite_get_rect(0, 1, 128, 128));
+		itu_lib_sprite_init_from_resource(&sprite, state->tex_space, itu_lib_sprite_get_rect(0, 1, 128, 128));
 
 		EX6_PlayerData data = { 0 };
 
@@ -539,7 +592,7 @@ static void game_reset(SDLContext* context, GameState* state)
 		transform.position.x = SDL_randf() * 16 - 8;
 		transform.position.y = SDL_randf() * 16 - 8;
 
-		itu_lib_sprite_init(&sprite, tex_space, itu_lib_sprite_get_rect(0, 4, 128, 128));
+		itu_lib_sprite_init_from_resource(&sprite, state->tex_space, itu_lib_sprite_get_rect(0, 4, 128, 128));
 
 		// FIXME this is thrash
 		PhysicsStaticData physics_data = { 0 };
@@ -568,8 +621,8 @@ static void game_reset(SDLContext* context, GameState* state)
 		transform.position = { 20, 18 };
 
 		EX6_Sprite9Patch   sprite;
-		sprite.rect = { 0, 0, 96, 16 };
-		sprite.texture = tex_healthbar;
+		sprite.rect = itu_sys_rstorage_texture_remap_rect(state->tex_healthbar, SDL_FRect { 0, 0, 96, 16 });
+		sprite.texture = itu_sys_rstorage_texture_get_ptr(state->tex_healthbar);
 		sprite.size = { 760, 16 };
 		sprite.margins_hor = { 8, 8 };
 		sprite.margins_ver = { 8, 8 };
@@ -595,8 +648,8 @@ static void game_reset(SDLContext* context, GameState* state)
 		transform.position = { 20, context->window_h - 18 };
 
 		EX6_Sprite9Patch sprite;
-		sprite.rect = { 0, 0, 64, 64 };
-		sprite.texture = tex_button;
+		sprite.rect = itu_sys_rstorage_texture_remap_rect(state->tex_button, SDL_FRect { 0, 0, 64, 64 });
+		sprite.texture = itu_sys_rstorage_texture_get_ptr(state->tex_button);
 		sprite.size = { 280, 48 };
 		sprite.margins_hor = { 8, 8 };
 		sprite.margins_ver = { 8, 8 };
@@ -604,10 +657,11 @@ static void game_reset(SDLContext* context, GameState* state)
 		sprite.pivot.y = 1.0f;
 		sprite.tint = COLOR_WHITE;
 
-		const char btn_text[] = "I am a button!";
 		EX6_ImageButton imagebutton = { 0 };
 		imagebutton.fn_callback_click = TMP_btn_callback_click;
-		imagebutton.ttf_text = TTF_CreateText(ttf_engine, font_bold, btn_text, SDL_strlen(btn_text));
+		imagebutton.font = font_bold;
+		imagebutton.text_color = COLOR_WHITE;
+		SDL_strlcpy(imagebutton.text, "I am a button!", ITU_TEXT_LENGTH_MAX);
 
 		entity_add_component(id, EX6_TransformScreen, transform);
 		entity_add_component(id, EX6_Sprite9Patch, sprite);
@@ -628,7 +682,7 @@ int main(void)
 
 	context.working_dir = SDL_GetCurrentDirectory();
 	context.window = SDL_CreateWindow("ES06 - UI", WINDOW_W, WINDOW_H, 0);
-	context.renderer = SDL_CreateRenderer(context.window, "vulkan");
+	context.renderer = SDL_CreateRenderer(context.window, NULL);
 	SDL_SetRenderDrawBlendMode(context.renderer, SDL_BLENDMODE_BLEND);
 	
 	// increase the zoom to make debug text more legible
@@ -681,6 +735,9 @@ int main(void)
 
 		SDL_SetRenderDrawColor(context.renderer, 0x00, 0x00, 0x00, 0x00);
 		SDL_RenderClear(context.renderer);
+		itu_sys_renderstats_frame_begin(&context);
+		itu_sys_rstorage_texture_stream_update(&context, MILLIS(2));
+		itu_sys_rstorage_hotreload_update(&context);
 		
 		itu_lib_imgui_frame_begin();
 
@@ -701,9 +758,20 @@ int main(void)
 						ImGui::LabelText("work", "%6.3f ms/f", (float)elapsed_work  / (float)MILLIS(1));
 						ImGui::LabelText("tot",  "%6.3f ms/f", (float)elapsed_frame / (float)MILLIS(1));
 						ImGui::LabelText("physics steps",  "%d", context.physics_steps_count);
+						ImGui::LabelText("UI layer redraws", "%d", itu_sys_uilayer_get_redraws_count());
+						ImGui::LabelText("textures streaming", "%d", itu_sys_rstorage_texture_stream_get_pending_count());
 
 						ImGui::EndTabItem();
 					}
+					if(ImGui::BeginTabItem("Render"))
+					{
+						// the cached UI layer must be redrawn to show up in (or disappear from) the overdraw view
+						bool overdraw_prev = itu_sys_renderstats_is_overdraw();
+						itu_sys_renderstats_debug_ui_render();
+						if(overdraw_prev != itu_sys_renderstats_is_overdraw())
+							itu_sys_uilayer_invalidate();
+						ImGui::EndTabItem();
+					}
 					if(ImGui::BeginTabItem("Entities"))
 					{
 						itu_sys_estorage_debug_render(&context);
@@ -741,4 +809,10 @@ int main(void)
 		context.elapsed_frame = elapsed_frame;
 		walltime_frame_beg = walltime_frame_end;
 	}
+
+	itu_sys_jobs_shutdown();
+	itu_sys_physics_shutdown();
+	itu_sys_rstorage_texture_stream_shutdown();
+	itu_sys_rstorage_hotreload_shutdown();
+	itu_sys_rstorage_pack_unmount();
 }
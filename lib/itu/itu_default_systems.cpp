@@ -1,17 +1,84 @@
 void itu_system_sprite_render(SDLContext* context, ITU_EntityId* entity_ids, int entity_ids_count)
 {
+	// camera frustum culling: sprites that do not intersect the visible world rect never reach the renderer
+	SDL_FRect rect_view = camera_get_world_rect(context, context->camera_active);
+
 	for(int i = 0; i < entity_ids_count; ++i)
 	{
 		ITU_EntityId id = entity_ids[i];
 		Transform* transform = entity_get_data(id, Transform);
 		Sprite*    sprite = entity_get_data(id, Sprite);
 
-		itu_lib_sprite_render(context, sprite, transform);
+		SDL_FRect rect_bounds = itu_lib_sprite_get_world_bounds(context, sprite, transform);
+		if(!SDL_HasRectIntersectionFloat(&rect_view, &rect_bounds))
+			continue;
+
+		// entity index as interpolation key (+1, 0 means "don't interpolate")
+		itu_sys_render_sprite_push_interpolated(sprite, transform, id.index + 1);
+	}
+
+	itu_sys_render_sprite_flush(context);
+}
+
+// text labels anchored to entities, drawn on top of sprites
+// NOTE: nothing is drawn in `itu_sys_render` snapshot mode (text drawing uses the SDL renderer, which belongs to the render thread)
+void itu_system_text_render(SDLContext* context, ITU_EntityId* entity_ids, int entity_ids_count)
+{
+	if(itu_sys_render_snapshot_is_enabled())
+		return;
+
+	SDL_FRect rect_view = rect_global_to_screen(context, camera_get_world_rect(context, context->camera_active));
+
+	for(int i = 0; i < entity_ids_count; ++i)
+	{
+		ITU_EntityId id = entity_ids[i];
+		Transform* transform = entity_get_data(id, Transform);
+		Text*      text = entity_get_data(id, Text);
+
+		if(!text->font || text->text[0] == 0)
+			continue;
+
+		vec2f position = point_global_to_screen(context, transform->position) + text->offset;
+
+		// layouts are cached, so getting the bounds of offscreen text is just a lookup
+		ITU_TextLayout* layout = itu_sys_text_layout_get(context, text->font, text->text);
+		SDL_FRect rect_text;
+		rect_text.w = layout->size.x * text->scale;
+		rect_text.h = layout->size.y * text->scale;
+		rect_text.x = position.x - text->pivot.x * rect_text.w;
+		rect_text.y = position.y - text->pivot.y * rect_text.h;
+		if(!SDL_HasRectIntersectionFloat(&rect_view, &rect_text))
+			continue;
+
+		itu_sys_text_queue_layout(layout, position, text->pivot, text->scale, text->tint);
+	}
+
+	itu_sys_text_flush(context);
+}
+
+// NOTE: this only queues chunks in the sprite batcher, so it needs to run before `itu_system_sprite_render` (which flushes it)
+void itu_system_tilemap_render(SDLContext* context, ITU_EntityId* entity_ids, int entity_ids_count)
+{
+	for(int i = 0; i < entity_ids_count; ++i)
+	{
+		ITU_EntityId id = entity_ids[i];
+		Transform* transform = entity_get_data(id, Transform);
+		Tilemap*   tilemap = entity_get_data(id, Tilemap);
+
+		itu_lib_tilemap_render(context, tilemap, transform);
 	}
 }
 
+// NOTE: body user data must be the entity id (see `itu_sys_physics_add_body`)
+// limitations
+// - sleeping bodies are not written back, so changing the transform of a sleeping entity directly is not undone anymore
+//   (move the body instead)
+// - a body moved with `b2Body_SetTransform` while sleeping interpolates from its old position for the first frame after waking up
 void itu_system_physics(SDLContext* context, ITU_EntityId* entity_ids, int entity_ids_count)
 {
+	// entities whose body moved during this frame steps are written back once after the last step
+	itu_sys_physics_moved_clear();
+
 	for(int i = 0; i < entity_ids_count; ++i)
 	{
 		ITU_EntityId id = entity_ids[i];
@@ -31,38 +98,69 @@ void itu_system_physics(SDLContext* context, ITU_EntityId* entity_ids, int entit
 		context->physics_steps_count++;
 		context->accumulator_physics -= PHYSICS_TIMESTEP_NSECS;
 
-		// update game state from b2d state, interpolating when physics step is out of synch with game logic
-		// NOTE: we need to read the b2d state every step in order to get a correct interpolation, even if it's wasteful
-		//       (there is definitely a way to adjust `t` and `t_inv` based on the numbers of steps done and do the reading only once,
-		//       marking it as a TODO for the future)
-		float t = (float)(context->accumulator_physics) / (float)PHYSICS_TIMESTEP_NSECS;
-		float t_inv = 1 - t;
-
-		for(int i = 0; i < entity_ids_count; ++i)
+		// keep the state of the last two steps for interpolation
+		// NOTE: move events only live until the next step, so they are consumed every step (only awake bodies have one)
+		b2BodyEvents body_events = itu_sys_physics_get_body_events();
+		for(int i = 0; i < body_events.moveCount; ++i)
 		{
-			ITU_EntityId id = entity_ids[i];
-			Transform*  transform = entity_get_data(id, Transform);
+			b2BodyMoveEvent* event = &body_events.moveEvents[i];
+			ITU_EntityId id = value_cast(ITU_EntityId, event->userData);
 			PhysicsData* physics_data = entity_get_data(id, PhysicsData);
+			if(!physics_data)
+				continue;
 
-			b2Vec2 physics_vel = b2Body_GetLinearVelocity(physics_data->body_id);
-			float  physics_trq = b2Body_GetAngularVelocity(physics_data->body_id);
-			b2Vec2 physics_pos = b2Body_GetPosition(physics_data->body_id);
-			b2Rot  physics_rot = b2Body_GetRotation(physics_data->body_id);
+			physics_data->fixed_step_velocity = physics_data->step_velocity;
+			physics_data->fixed_step_torque   = physics_data->step_torque;
+			physics_data->fixed_step_position = physics_data->step_position;
+			physics_data->fixed_step_rotation = physics_data->step_rotation;
 
-			physics_data->velocity = value_cast(vec2f, physics_vel) * t + physics_data->fixed_step_velocity * t_inv;
-			physics_data->torque   = physics_trq * t + physics_data->fixed_step_torque * t_inv;
+			b2Vec2 physics_vel = b2Body_GetLinearVelocity(event->bodyId);
+			physics_data->step_velocity = value_cast(vec2f, physics_vel);
+			physics_data->step_torque   = b2Body_GetAngularVelocity(event->bodyId);
+			physics_data->step_position = value_cast(vec2f, event->transform.p);
+			physics_data->step_rotation = b2Rot_GetAngle(event->transform.q);
 
+			// last event until it wakes up, settle exactly on the final state
+			if(event->fellAsleep)
+			{
+				physics_data->fixed_step_velocity = physics_data->step_velocity;
+				physics_data->fixed_step_torque   = physics_data->step_torque;
+				physics_data->fixed_step_position = physics_data->step_position;
+				physics_data->fixed_step_rotation = physics_data->step_rotation;
+			}
 
-			if(!physics_data->ignore_position)
-				transform->position = value_cast(vec2f, physics_pos) * t + physics_data->fixed_step_position * t_inv;
+			if(!physics_data->sync_pending)
+			{
+				physics_data->sync_pending = true;
+				itu_sys_physics_moved_push(event->userData);
+			}
+		}
+	}
 
-			if(!physics_data->ignore_rotation)
-				transform->rotation = b2Rot_GetAngle(physics_rot) * t + physics_data->fixed_step_rotation * t_inv;
+	if(context->physics_steps_count == 0)
+		return;
 
-			physics_data->fixed_step_velocity = value_cast(vec2f, physics_vel);
-			physics_data->fixed_step_torque = physics_trq;
-			physics_data->fixed_step_position = value_cast(vec2f, physics_pos);
-			physics_data->fixed_step_rotation = b2Rot_GetAngle(physics_rot);
-		}
+	// update game state from b2d state, interpolating when physics step is out of synch with game logic
+	float t = (float)(context->accumulator_physics) / (float)PHYSICS_TIMESTEP_NSECS;
+	float t_inv = 1 - t;
+
+	int entities_moved_count;
+	void** entities_moved = itu_sys_physics_moved_get(&entities_moved_count);
+	for(int i = 0; i < entities_moved_count; ++i)
+	{
+		ITU_EntityId id = value_cast(ITU_EntityId, entities_moved[i]);
+		Transform*  transform = entity_get_data(id, Transform);
+		PhysicsData* physics_data = entity_get_data(id, PhysicsData);
+		physics_data->sync_pending = false;
+
+		physics_data->velocity = physics_data->step_velocity * t + physics_data->fixed_step_velocity * t_inv;
+		physics_data->torque   = physics_data->step_torque * t + physics_data->fixed_step_torque * t_inv;
+
+		if(!physics_data->ignore_position)
+			transform->position = physics_data->step_position * t + physics_data->fixed_step_position * t_inv;
+
+		if(!physics_data->ignore_rotation)
+			transform->rotation = physics_data->step_rotation * t + physics_data->fixed_step_rotation * t_inv;
 	}
+	itu_sys_physics_moved_clear();
 }
@@ -1,6 +1,7 @@
 ﻿#ifndef ITU_UNITY_BUILD
 #include <itu_entity_storage.hpp>
 #include <imgui/imgui.h>
+#include <itu_sys_renderstats.hpp>
 #endif
 
 struct ITU_Component
@@ -45,6 +46,10 @@ struct ITU_System
 	int tags_count;
 
 	ITU_SystemUpdateFunction fn_update;
+
+	// timings (updated by `itu_sys_estorage_systems_update`)
+	SDL_Time elapsed_last;
+	SDL_Time elapsed_total;
 };
 
 struct ITU_Entity
@@ -128,15 +133,21 @@ void itu_sys_estorage_init(int starting_entities_count, bool enable_standard_com
 		enable_component(PhysicsData);
 		enable_component(PhysicsStaticData);
 		enable_component(ShapeData);
+		enable_component(Tilemap);
+		enable_component(Text);
 
 		add_component_debug_ui_render(ShapeData, itu_debug_ui_render_shapedata);
 		add_component_debug_ui_render(Transform, itu_debug_ui_render_transform);
 		add_component_debug_ui_render(Sprite, itu_debug_ui_render_sprite);
 		add_component_debug_ui_render(PhysicsData, itu_debug_ui_render_physicsdata);
 		add_component_debug_ui_render(PhysicsStaticData, itu_debug_ui_render_physicsstaticdata);
+		add_component_debug_ui_render(Tilemap, itu_debug_ui_render_tilemap);
+		add_component_debug_ui_render(Text, itu_debug_ui_render_text);
 
 		add_system(itu_system_physics       , component_mask(PhysicsData)                                  , 0);
+		add_system(itu_system_tilemap_render, component_mask(Transform)   | component_mask(Tilemap)        , 0);
 		add_system(itu_system_sprite_render , component_mask(Transform)   | component_mask(Sprite)         , 0);
+		add_system(itu_system_text_render   , component_mask(Transform)   | component_mask(Text)           , 0);
 	}
 }
 
@@ -283,9 +294,30 @@ void itu_sys_estorage_systems_update(SDLContext* context)
 	{
 		ITU_System* system = &ctx_estorage.systems[i];
 		ITU_EntityId system_ids[ENTITIES_COUNT_MAX];
+		SDL_Time walltime_beg;
+		SDL_Time walltime_end;
+		SDL_GetCurrentTime(&walltime_beg);
+
 		int system_ids_count = itu_system_get_matching_entities(system, system_ids);
 
+		itu_sys_renderstats_scope_begin(system->name);
 		system->fn_update(context, system_ids, system_ids_count);
+		itu_sys_renderstats_scope_end();
+
+		SDL_GetCurrentTime(&walltime_end);
+		system->elapsed_last = walltime_end - walltime_beg;
+		system->elapsed_total += system->elapsed_last;
+	}
+}
+
+// logs the average time spent in each system over the last `frames_count` frames, then resets the timings
+void itu_sys_estorage_log_timings(int frames_count)
+{
+	for(int i = 0; i < ctx_estorage.systems_count; ++i)
+	{
+		ITU_System* system = &ctx_estorage.systems[i];
+		SDL_Log("  %-32s %8.3f ms/f", system->name, NS_TO_MILLIS(system->elapsed_total / frames_count));
+		system->elapsed_total = 0;
 	}
 }
 
@@ -444,13 +476,14 @@ void itu_sys_estorage_debug_render(SDLContext* context)
 
 		if(ImGui::CollapsingHeader("Systems", ImGuiTreeNodeFlags_DefaultOpen))
 		{
-			if(ImGui::BeginTable("debug_estorage_master_systems", 5, ImGuiTableFlags_SizingFixedFit))
+			if(ImGui::BeginTable("debug_estorage_master_systems", 6, ImGuiTableFlags_SizingFixedFit))
 			{
 				ImGui::TableSetupColumn("");
 				ImGui::TableSetupColumn("name");
 				ImGui::TableSetupColumn("comp");
 				ImGui::TableSetupColumn("tags");
 				ImGui::TableSetupColumn("entities");
+				ImGui::TableSetupColumn("ms");
 				ImGui::TableHeadersRow();
 				for(int i = 0; i < ctx_estorage.systems_count; ++i)
 				{
@@ -499,6 +532,9 @@ void itu_sys_estorage_debug_render(SDLContext* context)
 
 					*system_ids_count = itu_system_get_matching_entities(system, system_ids);
 					ImGui::Text("%d", *system_ids_count);
+
+					ImGui::TableNextColumn();
+					ImGui::Text("%6.3f", (float)system->elapsed_last / (float)MILLIS(1));
 				}
 
 				ImGui::EndTable();
@@ -70,12 +70,15 @@ register_component(Sprite)
 register_component(PhysicsData)
 register_component(PhysicsStaticData)
 register_component(ShapeData)
+register_component(Tilemap)
+register_component(Text)
 
 void itu_sys_estorage_init(int starting_entities_count, bool enable_standard_components);
 void itu_sys_estorage_clear_all_entities();
 void itu_sys_estorage_add_system(ITU_SystemDef system_def);
 void itu_sys_estorage_set_systems(ITU_SystemDef* systems, int systems_count);
 void itu_sys_estorage_systems_update(SDLContext* context);
+void itu_sys_estorage_log_timings(int frames_count);
 
 void itu_sys_estorage_tag_set_debug_name(int tag, const char* tag_debug_name);
 void itu_sys_estorage_debug_render(SDLContext* context);
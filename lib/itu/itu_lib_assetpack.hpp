@@ -0,0 +1,134 @@
+// itu_lib_assetpack.hpp
+// asset pack file format: all the files of a data folder in a single file, with images already decoded, so that the game
+// can memory-map it and upload textures straight from the mapped pages (no file opening, no decoding at startup).
+// Packs are built offline by `examples/04_asset_packer` (build target `asset_pack`), and mounted at runtime with
+// `itu_sys_rstorage_pack_mount`
+//
+// layout
+// - ITU_AssetPackHeader
+// - ITU_AssetPackEntry[entries_count], sorted by path
+// - entries data, every block aligned to ITU_ASSETPACK_DATA_ALIGNMENT
+//
+// images are stored as tightly packed pixels (pitch is `w * SDL_BYTESPERPIXEL(format)`), everything else (fonts, audio, ...)
+// as-is. The format is RGBA32, or a 16 bit one when it stores the image exactly (see `itu_lib_assetpack_image_compact_format`)
+//
+// limitations
+// - paths are stored normalized (see `itu_lib_fileutils_normalize_path`) and relative to the packer working directory, so
+//   the pack must be built from the same directory the game runs from
+// - numbers are stored in the packer endianness, packs are not portable across platforms with different endianness
+// - images take much more space than the compressed originals (tradeoff: disk space for load time)
+
+#ifndef ITU_LIB_ASSETPACK_HPP
+#define ITU_LIB_ASSETPACK_HPP
+
+#ifndef ITU_UNITY_BUILD
+#include <SDL3/SDL.h>
+#endif
+
+#define ITU_ASSETPACK_MAGIC          0x50555449 // "ITUP"
+#define ITU_ASSETPACK_VERSION        2 // 2: 16 bit image formats
+#define ITU_ASSETPACK_PATH_MAX       128
+#define ITU_ASSETPACK_DATA_ALIGNMENT 64
+
+enum ITU_AssetPackEntryType
+{
+	ITU_ASSETPACK_ENTRY_TYPE_RAW,   // file content, unchanged
+	ITU_ASSETPACK_ENTRY_TYPE_IMAGE, // decoded pixels, `w` x `h` in `format`
+};
+
+struct ITU_AssetPackHeader
+{
+	Uint32 magic;
+	Uint32 version;
+	Uint32 entries_count;
+	Uint32 reserved;
+};
+
+struct ITU_AssetPackEntry
+{
+	char   path[ITU_ASSETPACK_PATH_MAX];
+	Uint32 type;   // ITU_AssetPackEntryType
+	Uint32 format; // SDL_PixelFormat, images only
+	Uint32 w;      // images only
+	Uint32 h;      // images only
+	Uint64 offset; // from the beginning of the pack
+	Uint64 size;   // in bytes
+};
+
+const ITU_AssetPackEntry* itu_lib_assetpack_get_entries(const void* pack, size_t pack_size, int* out_entries_count);
+const void*               itu_lib_assetpack_get_entry_data(const void* pack, const ITU_AssetPackEntry* entry);
+SDL_PixelFormat           itu_lib_assetpack_image_compact_format(const Uint8* pixels, int w, int h, bool lossy);
+
+#endif // ITU_LIB_ASSETPACK_HPP
+
+#if (defined ITU_LIB_ASSETPACK_IMPLEMENTATION) || (defined ITU_UNITY_BUILD)
+
+// validates header and entries of a pack loaded (or mapped) in memory, returns NULL if the pack is invalid
+const ITU_AssetPackEntry* itu_lib_assetpack_get_entries(const void* pack, size_t pack_size, int* out_entries_count)
+{
+	*out_entries_count = 0;
+
+	if(pack_size < sizeof(ITU_AssetPackHeader))
+		return NULL;
+
+	const ITU_AssetPackHeader* header = (const ITU_AssetPackHeader*)pack;
+	if(header->magic != ITU_ASSETPACK_MAGIC || header->version != ITU_ASSETPACK_VERSION)
+		return NULL;
+
+	if(pack_size < sizeof(ITU_AssetPackHeader) + (size_t)header->entries_count * sizeof(ITU_AssetPackEntry))
+		return NULL;
+
+	const ITU_AssetPackEntry* entries = (const ITU_AssetPackEntry*)(header + 1);
+	for(Uint32 i = 0; i < header->entries_count; ++i)
+	{
+		const ITU_AssetPackEntry* entry = &entries[i];
+		if(entry->offset > pack_size || entry->size > pack_size - entry->offset)
+			return NULL;
+		if(SDL_strnlen(entry->path, ITU_ASSETPACK_PATH_MAX) == ITU_ASSETPACK_PATH_MAX)
+			return NULL;
+		if(entry->type == ITU_ASSETPACK_ENTRY_TYPE_IMAGE && entry->size != (Uint64)entry->w * entry->h * SDL_BYTESPERPIXEL((SDL_PixelFormat)entry->format))
+			return NULL;
+	}
+
+	*out_entries_count = (int)header->entries_count;
+	return entries;
+}
+
+const void* itu_lib_assetpack_get_entry_data(const void* pack, const ITU_AssetPackEntry* entry)
+{
+	return (const Uint8*)pack + entry->offset;
+}
+
+// smallest format that can hold the given RGBA32 image: RGB565 if opaque, RGBA5551 if alpha is only 0 or 255, RGBA4444
+// otherwise. If not `lossy`, the format must store the image exactly (ie, pixel art drawn with a small palette), otherwise
+// RGBA32 is returned
+// NOTE: exactness is checked with a round trip through `SDL_ConvertPixels`, the same conversion used to upload
+SDL_PixelFormat itu_lib_assetpack_image_compact_format(const Uint8* pixels, int w, int h, bool lossy)
+{
+	bool alpha_opaque = true;
+	bool alpha_binary = true;
+	size_t pixels_count = (size_t)w * h;
+	for(size_t i = 0; i < pixels_count && alpha_binary; ++i)
+	{
+		Uint8 a = pixels[i * 4 + 3];
+		alpha_opaque &= a == 0xFF;
+		alpha_binary &= a == 0xFF || a == 0x00;
+	}
+
+	SDL_PixelFormat ret = alpha_opaque ? SDL_PIXELFORMAT_RGB565 : alpha_binary ? SDL_PIXELFORMAT_RGBA5551 : SDL_PIXELFORMAT_RGBA4444;
+	if(lossy)
+		return ret;
+
+	Uint8* pixels_compact = (Uint8*)SDL_malloc(pixels_count * 2);
+	Uint8* pixels_roundtrip = (Uint8*)SDL_malloc(pixels_count * 4);
+	bool exact =
+		SDL_ConvertPixels(w, h, SDL_PIXELFORMAT_RGBA32, pixels, w * 4, ret, pixels_compact, w * 2) &&
+		SDL_ConvertPixels(w, h, ret, pixels_compact, w * 2, SDL_PIXELFORMAT_RGBA32, pixels_roundtrip, w * 4) &&
+		SDL_memcmp(pixels, pixels_roundtrip, pixels_count * 4) == 0;
+	SDL_free(pixels_compact);
+	SDL_free(pixels_roundtrip);
+
+	return exact ? ret : SDL_PIXELFORMAT_RGBA32;
+}
+
+#endif // (defined ITU_LIB_ASSETPACK_IMPLEMENTATION) || (defined ITU_UNITY_BUILD)
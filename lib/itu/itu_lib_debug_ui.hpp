@@ -6,6 +6,8 @@ void itu_debug_ui_render_sprite(SDLContext* context, void* data);
 void itu_debug_ui_render_physicsdata(SDLContext* context, void* data);
 void itu_debug_ui_render_physicsstaticdata(SDLContext* context, void* data);
 void itu_debug_ui_render_shapedata(SDLContext* context, void* data);
+void itu_debug_ui_render_tilemap(SDLContext* context, void* data);
+void itu_debug_ui_render_text(SDLContext* context, void* data);
 
 #endif // ITU_LIB_DEBUG_UI_HPP
 
@@ -44,6 +46,33 @@ void itu_debug_ui_render_sprite(SDLContext* context, void* data)
 
 	ImGui::ColorEdit4("tint", &data_sprite->tint.r);
 	ImGui::Checkbox("Flip Hor.", &data_sprite->flip_horizontal);
+	ImGui::DragInt("layer", &data_sprite->layer);
+}
+
+void itu_debug_ui_render_tilemap(SDLContext* context, void* data)
+{
+	Tilemap* data_tilemap = (Tilemap*)data;
+
+	ImGui::Text("tiles : %d x %d", data_tilemap->num_cols, data_tilemap->num_rows);
+	ImGui::Text("chunks: %d x %d", data_tilemap->chunks_num_cols, data_tilemap->chunks_num_rows);
+	ImGui::DragInt("layer", &data_tilemap->layer);
+	if(ImGui::Button("Rebake all chunks"))
+		itu_lib_tilemap_set_dirty_all(data_tilemap);
+}
+
+void itu_debug_ui_render_text(SDLContext* context, void* data)
+{
+	Text* data_text = (Text*)data;
+
+	TTF_Font* new_font;
+	if(itu_sys_rstorage_debug_render_font(data_text->font, &new_font))
+		data_text->font = new_font;
+
+	ImGui::InputText("text", data_text->text, ITU_TEXT_LENGTH_MAX);
+	ImGui::ColorEdit4("tint", &data_text->tint.r);
+	ImGui::DragFloat2("pivot", &data_text->pivot.x, 0.01f);
+	ImGui::DragFloat2("offset", &data_text->offset.x);
+	ImGui::DragFloat("scale", &data_text->scale, 0.01f);
 }
 
 void itu_debug_ui_render_physicsdata(SDLContext* context, void* data)
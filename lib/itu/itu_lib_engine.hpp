@@ -55,6 +55,7 @@ struct SDLContext
 
 	SDL_Window* window;
 	SDL_Renderer* renderer;
+	SDL_Surface* headless_surface; // framebuffer of the software renderer in headless mode (NULL otherwise)
 	float zoom;     // render zoom
 	float window_w;	// current window width after render zoom has been applied
 	float window_h;	// current window width after render zoom has been applied
@@ -110,7 +111,9 @@ struct SDLContext
 #define TRANSFORM_DEFAULT Transform { { 0, 0 }, { 1, 1 }, 0 }
 
 void camera_set_active(SDLContext* context, Camera* camera);
+SDL_FRect camera_get_world_rect(SDLContext* context, Camera* camera);
 SDL_FRect rect_global_to_screen(SDLContext* context, SDL_FRect rect);
+float size_global_to_screen(SDLContext* context, float size);
 vec2f point_global_to_screen(SDLContext* context, vec2f p);
 vec2f point_screen_to_global(SDLContext* context, vec2f p);
 vec2f point_screen_to_window(SDLContext* context, vec2f p);
@@ -118,8 +121,12 @@ vec2f point_window_to_screen(SDLContext* context, vec2f p);
 void sdl_input_clear(SDLContext* context);
 void sdl_input_key_process(SDLContext* context, BtnType button_id, SDL_Event* event);
 SDL_Texture* texture_create(SDLContext* context, const char* path, SDL_ScaleMode mode);
+SDL_Texture* texture_create_from_pixels(SDLContext* context, unsigned char* pixels, int w, int h, SDL_ScaleMode mode);
+SDL_Texture* texture_create_from_pixels_format(SDLContext* context, const void* pixels, SDL_PixelFormat format, int w, int h, SDL_ScaleMode mode);
 void sdl_set_render_draw_color(SDLContext* context, color c);
 void sdl_set_texture_tint(SDL_Texture* texture, color c);
+bool sdl_context_init_headless(SDLContext* context, int w, int h);
+Uint32 sdl_context_framebuffer_checksum(SDLContext* context);
 
 #endif // ITU_LIB_ENGINE_HPP
 
@@ -149,6 +156,23 @@ SDL_FRect camera_get_viewport_rect(SDLContext* context, Camera* camera)
 	return rect;
 }
 
+// returns the world-space rect seen by the given camera (x, y is the bottom-left corner, since world y-axis points up)
+// NOTE: meant to be computed once per frame and used for visibility tests (see `itu_system_sprite_render`)
+SDL_FRect camera_get_world_rect(SDLContext* context, Camera* camera)
+{
+	vec2f camera_size;
+	camera_size.x = (context->window_w / camera->pixels_per_unit) * camera->normalized_screen_size.x / camera->zoom;
+	camera_size.y = (context->window_h / camera->pixels_per_unit) * camera->normalized_screen_size.y / camera->zoom;
+
+	SDL_FRect rect;
+	rect.x = camera->world_position.x - camera_size.x / 2;
+	rect.y = camera->world_position.y - camera_size.y / 2;
+	rect.w = camera_size.x;
+	rect.h = camera_size.y;
+
+	return rect;
+}
+
 // converts the given rect to the viewport of the given camera
 SDL_FRect rect_global_to_screen(SDLContext* context, SDL_FRect rect)
 {
@@ -371,17 +395,38 @@ SDL_Texture* texture_create(SDLContext* context, const char* path, SDL_ScaleMode
 	// TODO how do we recover from inability to load the asset? Do we want to?
 	SDL_assert(pixels);
 
-	SDL_Surface* surface = SDL_CreateSurfaceFrom(w, h, pixel_format, pixels, w * num_components_requested);
+	SDL_Texture* ret = texture_create_from_pixels_format(context, pixels, pixel_format, w, h, mode);
 
-	SDL_Texture* ret = SDL_CreateTextureFromSurface(context->renderer, surface);
-	SDL_SetTextureScaleMode(ret, mode);
-
-	SDL_DestroySurface(surface);
 	stbi_image_free(pixels);
 
 	return ret;
 }
 
+// creates a texture from already decoded RGBA32 pixels (ie, from `stbi_load` with 4 requested components)
+// NOTE: the texture is created directly in the decoded format and the pixels are uploaded as they are, without going through
+//       an intermediate surface (`SDL_CreateTextureFromSurface` may pick a different format and convert into a temporary copy).
+//       Static access, since streaming textures keep a CPU-side copy of their pixels on some backends
+// NOTE: this is not zero-copy, stb_image can only decode into its own buffer, so peak memory is still decoded pixels + texture
+//       (packed images, see `itu_lib_assetpack.hpp`, skip the decode buffer)
+SDL_Texture* texture_create_from_pixels(SDLContext* context, unsigned char* pixels, int w, int h, SDL_ScaleMode mode)
+{
+	return texture_create_from_pixels_format(context, pixels, SDL_PIXELFORMAT_RGBA32, w, h, mode);
+}
+
+// same as `texture_create_from_pixels`, for tightly packed pixels in any format (ie, 16 bit formats, to save texture memory)
+SDL_Texture* texture_create_from_pixels_format(SDLContext* context, const void* pixels, SDL_PixelFormat format, int w, int h, SDL_ScaleMode mode)
+{
+	SDL_Texture* ret = SDL_CreateTexture(context->renderer, format, SDL_TEXTUREACCESS_STATIC, w, h);
+	if(!ret)
+		return NULL;
+
+	SDL_UpdateTexture(ret, NULL, pixels, w * SDL_BYTESPERPIXEL(format));
+	SDL_SetTextureBlendMode(ret, SDL_BLENDMODE_BLEND);
+	SDL_SetTextureScaleMode(ret, mode);
+
+	return ret;
+}
+
 void sdl_set_render_draw_color(SDLContext* context, color c)
 {
 	SDL_SetRenderDrawColorFloat(context->renderer, c.r, c.g, c.b, c.a);
@@ -404,6 +449,57 @@ void sdl_render_diagnostics(SDLContext* context, float elapsed_work, float elaps
 	SDL_RenderDebugTextFormat(context->renderer, 10, 20, "tot : %6.3f ms/f", (float)elapsed_frame / (float)MILLIS(1));
 }
 
+// creates a software renderer drawing into an offscreen surface, with no window
+// (ie, for benchmarks on machines without a GPU or a display)
+bool sdl_context_init_headless(SDLContext* context, int w, int h)
+{
+	context->window = NULL;
+	context->headless_surface = SDL_CreateSurface(w, h, SDL_PIXELFORMAT_RGBA32);
+	if(!context->headless_surface)
+	{
+		SDL_Log("ERROR creating headless surface: %s", SDL_GetError());
+		return false;
+	}
+
+	context->renderer = SDL_CreateSoftwareRenderer(context->headless_surface);
+	if(!context->renderer)
+	{
+		SDL_Log("ERROR creating software renderer: %s", SDL_GetError());
+		SDL_DestroySurface(context->headless_surface);
+		context->headless_surface = NULL;
+		return false;
+	}
+
+	context->zoom = 1;
+	context->window_w = w;
+	context->window_h = h;
+	SDL_SetRenderDrawBlendMode(context->renderer, SDL_BLENDMODE_BLEND);
+
+	return true;
+}
+
+// checksum of what has been rendered so far in the current render target. Meant to detect changes in rendering output
+// between runs (so it's only meaningful with the software renderer, GPU output is not guaranteed to be bit-exact)
+Uint32 sdl_context_framebuffer_checksum(SDLContext* context)
+{
+	SDL_Surface* surface = SDL_RenderReadPixels(context->renderer, NULL);
+	if(!surface)
+	{
+		SDL_Log("ERROR reading framebuffer: %s", SDL_GetError());
+		return 0;
+	}
+
+	// NOTE: rows can be padded, so we only hash the actual pixels of each row
+	Uint32 ret = 0;
+	int row_size = surface->w * SDL_BYTESPERPIXEL(surface->format);
+	for(int y = 0; y < surface->h; ++y)
+		ret = SDL_crc32(ret, (Uint8*)surface->pixels + y * surface->pitch, row_size);
+
+	SDL_DestroySurface(surface);
+
+	return ret;
+}
+
 // busy waits to introduce artificial delay
 void engine_artificial_delay(float delay_ms, float delay_spread_ms)
 {
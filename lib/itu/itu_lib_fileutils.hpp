@@ -1,7 +1,14 @@
 #ifndef ITU_LIB_FILEUTILS_HPP
 #define ITU_LIB_FILEUTILS_HPP
 
+#ifndef ITU_UNITY_BUILD
+#include <SDL3/SDL.h>
+#endif
+
 const char* itu_lib_fileutils_get_file_name(const char* path);
+void        itu_lib_fileutils_normalize_path(const char* path, char* out, int out_len);
+const void* itu_lib_fileutils_map_file(const char* path, size_t* out_size);
+void        itu_lib_fileutils_unmap_file(const void* data, size_t size);
 
 #endif // ITU_LIB_FILEUTILS_HPP
 
@@ -11,7 +18,22 @@ const char* itu_lib_fileutils_get_file_name(const char* path);
 #if (defined ITU_LIB_FILEUTILS_IMPLEMENTATION) || (defined ITU_UNITY_BUILD)
 
 #ifndef ITU_UNITY_BUILD
-#include <SDL3/SDL_h>
+#include <SDL3/SDL.h>
+#endif
+
+#ifdef SDL_PLATFORM_WINDOWS
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #endif
 
 
@@ -35,4 +57,138 @@ const char* itu_lib_fileutils_get_file_name(const char* path)
 	return ret;
 }
 
+// writes in `out` a canonical version of `path`, so that different spellings of the same file compare equal
+// (ie, "data/./kenney//a.png" and "data/UI/../kenney/a.png" both become "data/kenney/a.png").
+// Separators become '/' (on Windows '\\' is a separator too), "." segments and repeated separators are removed,
+// ".." segments are resolved when possible.
+// On Windows the path is also lowercased, since the file system is case insensitive.
+// NOTE: symbolic links are not resolved
+void itu_lib_fileutils_normalize_path(const char* path, char* out, int out_len)
+{
+	SDL_assert(out_len > 0);
+
+	int len = 0;
+	bool is_absolute = is_path_separator(*path);
+	if(is_absolute && len < out_len - 1)
+		out[len++] = '/';
+
+	const char* segment_beg = path;
+	while(*segment_beg)
+	{
+		while(is_path_separator(*segment_beg))
+			++segment_beg;
+		const char* segment_end = segment_beg;
+		while(*segment_end && !is_path_separator(*segment_end))
+			++segment_end;
+		int segment_len = (int)(segment_end - segment_beg);
+
+		bool is_parent = segment_len == 2 && segment_beg[0] == '.' && segment_beg[1] == '.';
+		if(segment_len == 0 || (segment_len == 1 && segment_beg[0] == '.') || (is_parent && is_absolute && len == 1))
+		{
+			// skip (there's nothing above the root)
+		}
+		else if(is_parent && len > (is_absolute ? 1 : 0))
+		{
+			// go back one segment, unless the previous one is a ".." we couldn't resolve
+			int prev_beg = len - 1;
+			while(prev_beg > 0 && out[prev_beg - 1] != '/')
+				--prev_beg;
+			bool prev_is_parent = len - prev_beg == 3 && out[prev_beg] == '.' && out[prev_beg + 1] == '.';
+			if(!prev_is_parent)
+				len = prev_beg;
+			else if(len + 3 < out_len)
+			{
+				out[len++] = '.';
+				out[len++] = '.';
+				out[len++] = '/';
+			}
+		}
+		else if(len + segment_len + 1 < out_len)
+		{
+			for(int i = 0; i < segment_len; ++i)
+			{
+#ifdef SDL_PLATFORM_WINDOWS
+				out[len++] = (char)SDL_tolower(segment_beg[i]);
+#else
+				out[len++] = segment_beg[i];
+#endif
+			}
+			out[len++] = '/';
+		}
+
+		segment_beg = segment_end;
+	}
+
+	// remove trailing separator (but keep the root)
+	if(len > (is_absolute ? 1 : 0) && out[len - 1] == '/')
+		--len;
+	out[len] = 0;
+}
+
+// maps the whole file in memory, read-only. Pages are loaded by the OS on first access, and shared with the file cache
+// (no copy). Returns NULL on failure (or if the file is empty)
+const void* itu_lib_fileutils_map_file(const char* path, size_t* out_size)
+{
+	*out_size = 0;
+
+#ifdef SDL_PLATFORM_WINDOWS
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(file == INVALID_HANDLE_VALUE)
+		return NULL;
+
+	LARGE_INTEGER size;
+	if(!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return NULL;
+	}
+
+	// NOTE: the view keeps the mapping (and the file) alive, so both handles can be closed right away
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(file);
+	if(!mapping)
+		return NULL;
+
+	const void* ret = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if(!ret)
+		return NULL;
+
+	*out_size = (size_t)size.QuadPart;
+	return ret;
+#else
+	int fd = open(path, O_RDONLY);
+	if(fd == -1)
+		return NULL;
+
+	struct stat file_stat;
+	if(fstat(fd, &file_stat) != 0 || file_stat.st_size == 0)
+	{
+		close(fd);
+		return NULL;
+	}
+
+	// NOTE: the mapping keeps the file alive, so it can be closed right away
+	void* ret = mmap(NULL, (size_t)file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(ret == MAP_FAILED)
+		return NULL;
+
+	*out_size = (size_t)file_stat.st_size;
+	return ret;
+#endif
+}
+
+void itu_lib_fileutils_unmap_file(const void* data, size_t size)
+{
+	if(!data)
+		return;
+
+#ifdef SDL_PLATFORM_WINDOWS
+	UnmapViewOfFile(data);
+#else
+	munmap((void*)data, size);
+#endif
+}
+
 #endif //  (defined ITU_LIB_FILEUTILS_IMPLEMENTATION) || (defined ITU_UNITY_BUILD)
\ No newline at end of file
@@ -1,5 +1,10 @@
 // itu_lib_renderer.hpp
 // simple library to render debug shapes
+// two flavours
+// - `itu_lib_render_draw_*`  immediate, every call is one or more SDL calls
+// - `itu_lib_render_queue_*` deferred, primitives are appended to a per-frame vertex buffer and submitted with a single
+//                            `SDL_RenderGeometry` call by `itu_lib_render_queue_flush` (to be called once, at the end of the frame).
+//                            Lines are converted to 1-pixel-wide quads, so every vertex can have its own color
 // limitations
 // - no rotation
 // - only polygons have color fill
@@ -35,10 +40,105 @@ void itu_lib_render_draw_world_polygon(SDLContext* context, vec2f position, cons
 
 void itu_lib_render_draw_world_grid(SDLContext* context);
 
+void itu_lib_render_queue_point(vec2f pos, float half_size, color color);
+void itu_lib_render_queue_line(vec2f p0, vec2f p1, color color);
+void itu_lib_render_queue_rect(vec2f min, vec2f extents, color color);
+void itu_lib_render_queue_rect_fill(vec2f min, vec2f extents, color color);
+void itu_lib_render_queue_circle(vec2f center, float radius, int vertex_count, color color);
+void itu_lib_render_queue_polygon(vec2f position, const vec2f* vertices, int vertex_count, color color);
+
+void itu_lib_render_queue_world_point(SDLContext* context, vec2f pos, float half_size, color color);
+void itu_lib_render_queue_world_line(SDLContext* context, vec2f p0, vec2f p1, color color);
+void itu_lib_render_queue_world_circle(SDLContext* context, vec2f center, float radius, int vertex_count, color color);
+void itu_lib_render_queue_world_polygon(SDLContext* context, vec2f position, const vec2f* vertices, int vertex_count, color color);
+void itu_lib_render_queue_world_grid(SDLContext* context);
+
+void itu_lib_render_queue_flush(SDL_Renderer* renderer);
+
 #endif // ITU_LIB_RENDER_HPP
 
 #if defined ITU_LIB_RENDER_IMPLEMENTATION || defined ITU_UNITY_BUILD
 
+// unit circle vertices, one table for each possible vertex count (filled the first time that vertex count is used)
+struct ITU_RenderUnitCircleTable
+{
+	bool  initialized[MAX_CIRCLE_VERTICES + 1];
+	vec2f vertices[MAX_CIRCLE_VERTICES + 1][MAX_CIRCLE_VERTICES];
+};
+ITU_RenderUnitCircleTable itu_lib_render_unit_circle_table;
+
+const vec2f* itu_lib_render_get_unit_circle(int vertex_count)
+{
+	SDL_assert(vertex_count > 2 && vertex_count <= MAX_CIRCLE_VERTICES);
+
+	vec2f* ret = itu_lib_render_unit_circle_table.vertices[vertex_count];
+	if(!itu_lib_render_unit_circle_table.initialized[vertex_count])
+	{
+		float angle_increment = TAU / vertex_count;
+		for(int i = 0; i < vertex_count; ++i)
+		{
+			ret[i].x = SDL_cosf(angle_increment * i);
+			ret[i].y = SDL_sinf(angle_increment * i);
+		}
+		itu_lib_render_unit_circle_table.initialized[vertex_count] = true;
+	}
+
+	return ret;
+}
+
+// NOTE: we are not using stb_ds here, since this library is also used outside of the unity build
+struct ITU_RenderQueue
+{
+	SDL_Vertex* vertices;
+	int         vertices_count;
+	int         vertices_capacity;
+
+	int* indices;
+	int  indices_count;
+	int  indices_capacity;
+};
+ITU_RenderQueue itu_lib_render_queue_data;
+
+// reserves space for the given number of vertices and indices, returning a pointer to the first new vertex.
+// `out_indices` points to the first new index, `out_vertex_base` is the value to add to indices local to this primitive
+SDL_Vertex* itu_lib_render_queue_reserve(int vertices_count, int indices_count, int** out_indices, int* out_vertex_base)
+{
+	ITU_RenderQueue* queue = &itu_lib_render_queue_data;
+
+	if(queue->vertices_count + vertices_count > queue->vertices_capacity)
+	{
+		queue->vertices_capacity = SDL_max(queue->vertices_capacity * 2, queue->vertices_count + vertices_count);
+		queue->vertices_capacity = SDL_max(queue->vertices_capacity, 1024);
+		queue->vertices = (SDL_Vertex*)SDL_realloc(queue->vertices, queue->vertices_capacity * sizeof(SDL_Vertex));
+	}
+	if(queue->indices_count + indices_count > queue->indices_capacity)
+	{
+		queue->indices_capacity = SDL_max(queue->indices_capacity * 2, queue->indices_count + indices_count);
+		queue->indices_capacity = SDL_max(queue->indices_capacity, 1024);
+		queue->indices = (int*)SDL_realloc(queue->indices, queue->indices_capacity * sizeof(int));
+	}
+
+	SDL_Vertex* ret = &queue->vertices[queue->vertices_count];
+	*out_indices = &queue->indices[queue->indices_count];
+	*out_vertex_base = queue->vertices_count;
+
+	queue->vertices_count += vertices_count;
+	queue->indices_count += indices_count;
+
+	return ret;
+}
+
+inline SDL_Vertex itu_lib_render_vertex(float x, float y, SDL_FColor c)
+{
+	SDL_Vertex ret;
+	ret.position.x = x;
+	ret.position.y = y;
+	ret.color = c;
+	ret.tex_coord.x = 0;
+	ret.tex_coord.y = 0;
+	return ret;
+}
+
 void itu_lib_render_draw_point(SDL_Renderer* renderer, vec2f pos, float half_size, color color)
 {
 	//itu_lib_render_draw_rect(renderer, pos - vec2f { size / 2, size / 2}, vec2f { size, size }, color);
@@ -84,18 +184,11 @@ void itu_lib_render_draw_circle(SDL_Renderer* renderer, vec2f center, float radi
 
 	SDL_FPoint points[MAX_CIRCLE_VERTICES + 1];
 	
-	float angle_increment = TAU / vertex_count;
-
-	// very slow, a lot of trig
-	// we could also do a single quadrant and mirror the rest
+	const vec2f* unit_circle = itu_lib_render_get_unit_circle(vertex_count);
 	for(int i = 0; i < vertex_count; ++i)
 	{
-		float angle = angle_increment * i;
-		float px = radius * SDL_cos(angle);
-		float py = radius * SDL_sin(angle);
-		// 1st quadrant
-		points[i].x = center.x + px;
-		points[i].y = center.y + py;
+		points[i].x = center.x + radius * unit_circle[i].x;
+		points[i].y = center.y + radius * unit_circle[i].y;
 	}
 	points[vertex_count] = points[0];
 	
@@ -165,14 +258,32 @@ void itu_lib_render_draw_world_polygon(SDLContext* context, vec2f position, cons
 	itu_lib_render_draw_polygon(context->renderer, point_global_to_screen(context, position), vertices, vertexCount, color);
 }
 
+// immediate like the other `draw` functions, but the lines are built in the queue buffers (after what is already queued,
+// that is left there for `itu_lib_render_queue_flush`) and drawn with a single `SDL_RenderGeometry` call
 void itu_lib_render_draw_world_grid(SDLContext* context)
+{
+	ITU_RenderQueue* queue = &itu_lib_render_queue_data;
+	int vertices_count_prev = queue->vertices_count;
+	int indices_count_prev = queue->indices_count;
+
+	itu_lib_render_queue_world_grid(context);
+
+	if(queue->indices_count > indices_count_prev)
+		SDL_RenderGeometry(context->renderer, NULL, queue->vertices, queue->vertices_count, queue->indices + indices_count_prev, queue->indices_count - indices_count_prev);
+
+	queue->vertices_count = vertices_count_prev;
+	queue->indices_count = indices_count_prev;
+}
+
+// one line every world unit, covering the active camera view
+void itu_lib_render_queue_world_grid(SDLContext* context)
 {
 	// const float spacing_min = 32;
 	// const float spacing_max = 128;
 	
 	Camera* camera = context->camera_active;
 
-	float spacing = spacing = camera->pixels_per_unit * camera->zoom;
+	float spacing = camera->pixels_per_unit * camera->zoom;
 
 	// float scaling_factor = 1;
 	// while(spacing > spacing_max)
@@ -207,14 +318,159 @@ void itu_lib_render_draw_world_grid(SDLContext* context)
 	offset.x = 0;
 	offset.y = 0;
 	
-	SDL_SetRenderDrawColorFloat(context->renderer, 0.7f, 0.7f, 0.7f, 0.5f);
+	color grid_color = { 0.7f, 0.7f, 0.7f, 0.5f };
 	float min_x = camera_window_min.x;
 	float min_y = camera_window_min.y;
 
 	for(float i = min_x + offset.x; i <= camera_window_max.x; i += spacing)
-		SDL_RenderLine(context->renderer, i, camera_window_min.y, i, camera_window_max.y);
+		itu_lib_render_queue_line(vec2f { i, camera_window_min.y }, vec2f { i, camera_window_max.y }, grid_color);
 
 	for(float i = min_y + offset.y; i <= camera_window_max.y; i += spacing)
-		SDL_RenderLine(context->renderer, camera_window_min.x, i, camera_window_max.x, i);
+		itu_lib_render_queue_line(vec2f { camera_window_min.x, i }, vec2f { camera_window_max.x, i }, grid_color);
+}
+
+void itu_lib_render_queue_line(vec2f p0, vec2f p1, color color)
+{
+	SDL_FColor c = { color.r, color.g, color.b, color.a };
+
+	// half-pixel offset perpendicular to the line
+	vec2f d = p1 - p0;
+	float len = SDL_sqrtf(d.x * d.x + d.y * d.y);
+	vec2f n = len > 0 ? vec2f { -d.y / len, d.x / len } * 0.5f : vec2f { 0.5f, 0 };
+
+	int* indices;
+	int vertex_base;
+	SDL_Vertex* vertices = itu_lib_render_queue_reserve(4, 6, &indices, &vertex_base);
+	vertices[0] = itu_lib_render_vertex(p0.x + n.x, p0.y + n.y, c);
+	vertices[1] = itu_lib_render_vertex(p1.x + n.x, p1.y + n.y, c);
+	vertices[2] = itu_lib_render_vertex(p1.x - n.x, p1.y - n.y, c);
+	vertices[3] = itu_lib_render_vertex(p0.x - n.x, p0.y - n.y, c);
+
+	indices[0] = vertex_base + 0;
+	indices[1] = vertex_base + 1;
+	indices[2] = vertex_base + 2;
+	indices[3] = vertex_base + 0;
+	indices[4] = vertex_base + 2;
+	indices[5] = vertex_base + 3;
+}
+
+void itu_lib_render_queue_point(vec2f pos, float half_size, color color)
+{
+	itu_lib_render_queue_line(vec2f { pos.x - half_size, pos.y }, vec2f { pos.x + half_size, pos.y }, color);
+	itu_lib_render_queue_line(vec2f { pos.x, pos.y - half_size }, vec2f { pos.x, pos.y + half_size }, color);
+}
+
+void itu_lib_render_queue_rect(vec2f min, vec2f extents, color color)
+{
+	vec2f max = min + extents;
+	itu_lib_render_queue_line(vec2f { min.x, min.y }, vec2f { max.x, min.y }, color);
+	itu_lib_render_queue_line(vec2f { max.x, min.y }, vec2f { max.x, max.y }, color);
+	itu_lib_render_queue_line(vec2f { max.x, max.y }, vec2f { min.x, max.y }, color);
+	itu_lib_render_queue_line(vec2f { min.x, max.y }, vec2f { min.x, min.y }, color);
+}
+
+void itu_lib_render_queue_rect_fill(vec2f min, vec2f extents, color color)
+{
+	SDL_FColor c = { color.r, color.g, color.b, color.a };
+	vec2f max = min + extents;
+
+	int* indices;
+	int vertex_base;
+	SDL_Vertex* vertices = itu_lib_render_queue_reserve(4, 6, &indices, &vertex_base);
+	vertices[0] = itu_lib_render_vertex(min.x, min.y, c);
+	vertices[1] = itu_lib_render_vertex(max.x, min.y, c);
+	vertices[2] = itu_lib_render_vertex(max.x, max.y, c);
+	vertices[3] = itu_lib_render_vertex(min.x, max.y, c);
+
+	indices[0] = vertex_base + 0;
+	indices[1] = vertex_base + 1;
+	indices[2] = vertex_base + 2;
+	indices[3] = vertex_base + 0;
+	indices[4] = vertex_base + 2;
+	indices[5] = vertex_base + 3;
+}
+
+// NOTE: same rules as `itu_lib_render_draw_circle`, vertex count must be smaller than `MAX_CIRCLE_VERTICES`
+void itu_lib_render_queue_circle(vec2f center, float radius, int vertex_count, color color)
+{
+	const vec2f* unit_circle = itu_lib_render_get_unit_circle(vertex_count);
+
+	// same as the immediate version, outline is always opaque
+	color.a = 1;
+
+	vec2f p_prev = vec2f { center.x + unit_circle[vertex_count - 1].x * radius, center.y + unit_circle[vertex_count - 1].y * radius };
+	for(int i = 0; i < vertex_count; ++i)
+	{
+		vec2f p = vec2f { center.x + unit_circle[i].x * radius, center.y + unit_circle[i].y * radius };
+		itu_lib_render_queue_line(p_prev, p, color);
+		p_prev = p;
+	}
+}
+
+void itu_lib_render_queue_polygon(vec2f position, const vec2f* vertices, int vertex_count, color color)
+{
+	SDL_FColor c = { color.r, color.g, color.b, color.a };
+
+	// fill (triangle fan)
+	int* indices;
+	int vertex_base;
+	SDL_Vertex* vs = itu_lib_render_queue_reserve(vertex_count, (vertex_count - 2) * 3, &indices, &vertex_base);
+	for(int i = 0; i < vertex_count; ++i)
+		vs[i] = itu_lib_render_vertex(position.x + vertices[i].x, position.y + vertices[i].y, c);
+
+	for(int i = 2; i < vertex_count; ++i)
+	{
+		*indices++ = vertex_base;
+		*indices++ = vertex_base + i - 1;
+		*indices++ = vertex_base + i;
+	}
+
+	// outline
+	color.a = 1;
+	for(int i = 0; i < vertex_count; ++i)
+	{
+		const vec2f* v0 = &vertices[i];
+		const vec2f* v1 = &vertices[(i + 1) % vertex_count];
+		itu_lib_render_queue_line(vec2f { position.x + v0->x, position.y + v0->y }, vec2f { position.x + v1->x, position.y + v1->y }, color);
+	}
+}
+
+void itu_lib_render_queue_world_point(SDLContext* context, vec2f pos, float half_size, color color)
+{
+	itu_lib_render_queue_point(point_global_to_screen(context, pos), half_size, color);
+}
+
+void itu_lib_render_queue_world_line(SDLContext* context, vec2f p0, vec2f p1, color color)
+{
+	itu_lib_render_queue_line(point_global_to_screen(context, p0), point_global_to_screen(context, p1), color);
+}
+
+void itu_lib_render_queue_world_circle(SDLContext* context, vec2f center, float radius, int vertex_count, color color)
+{
+	itu_lib_render_queue_circle(point_global_to_screen(context, center), size_global_to_screen(context, radius), vertex_count, color);
+}
+
+// NOTE: unlike `itu_lib_render_draw_world_polygon`, vertices are in world space too (relative to `position`)
+void itu_lib_render_queue_world_polygon(SDLContext* context, vec2f position, const vec2f* vertices, int vertex_count, color color)
+{
+	SDL_assert(vertex_count <= MAX_CIRCLE_VERTICES * 8);
+
+	vec2f vertices_screen[MAX_CIRCLE_VERTICES * 8];
+	for(int i = 0; i < vertex_count; ++i)
+		vertices_screen[i] = point_global_to_screen(context, vec2f { position.x + vertices[i].x, position.y + vertices[i].y });
+
+	itu_lib_render_queue_polygon(VEC2F_ZERO, vertices_screen, vertex_count, color);
+}
+
+// submits everything queued since the last flush with a single draw call
+void itu_lib_render_queue_flush(SDL_Renderer* renderer)
+{
+	ITU_RenderQueue* queue = &itu_lib_render_queue_data;
+
+	if(queue->indices_count > 0)
+		SDL_RenderGeometry(renderer, NULL, queue->vertices, queue->vertices_count, queue->indices, queue->indices_count);
+
+	queue->vertices_count = 0;
+	queue->indices_count = 0;
 }
 # endif //ITU_LIB_RENDER_IMPLEMENTATION
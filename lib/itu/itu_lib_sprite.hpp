@@ -3,6 +3,7 @@
 
 #ifndef ITU_UNITY_BUILD
 #include <itu_lib_engine.hpp>
+#include <itu_sys_renderstats.hpp>
 #endif
 
 struct Sprite
@@ -12,12 +13,18 @@ struct Sprite
 	vec2f        pivot;
 	color        tint;
 	bool         flip_horizontal;
+	int          layer; // sprites in lower layers are rendered first
 };
 
 void itu_lib_sprite_init(Sprite* sprite, SDL_Texture* texture, SDL_FRect rect);
+// resource storage is only compiled in unity builds
+#ifdef ITU_UNITY_BUILD
+void itu_lib_sprite_init_from_resource(Sprite* sprite, ITU_IdTexture texture_id, SDL_FRect rect);
+#endif
 SDL_FRect itu_lib_sprite_get_rect(int x, int y, int tile_w, int tile_h);
 SDL_FRect itu_lib_sprite_get_screen_rect(SDLContext* context, Sprite* sprite, Transform* transform);
 vec2f itu_lib_sprite_get_world_size(SDLContext* context, Sprite* sprite, Transform* transform);
+SDL_FRect itu_lib_sprite_get_world_bounds(SDLContext* context, Sprite* sprite, Transform* transform);
 void itu_lib_sprite_render(SDLContext* context, Sprite* sprite, Transform* transform);
 void itu_lib_sprite_render_debug(SDLContext* context, Sprite* sprite, Transform* transform);
 
@@ -29,14 +36,31 @@ void itu_lib_sprite_render_debug(SDLContext* context, Sprite* sprite, Transform*
 
 
 // inits sprite with reasonable defaults
+// NOTE: `rect` is used as it is, so textures packed in an atlas page must go through `itu_lib_sprite_init_from_resource`
 void itu_lib_sprite_init(Sprite* sprite, SDL_Texture* texture, SDL_FRect rect)
 {
+#ifdef ITU_UNITY_BUILD
+	SDL_assert(!itu_sys_rstorage_texture_is_atlas_page(texture) && "packed texture, use itu_lib_sprite_init_from_resource");
+#endif
+
 	sprite->texture = texture;
 	sprite->rect = rect;
 	sprite->pivot = vec2f{ 0.5f, 0.5f };
 	sprite->tint = COLOR_WHITE;
+	sprite->flip_horizontal = false;
+	sprite->layer = 0;
 }
 
+#ifdef ITU_UNITY_BUILD
+// same as `itu_lib_sprite_init`, but takes a resource storage texture. `rect` is relative to the original image,
+// and it is remapped to the atlas page if the texture has been packed
+void itu_lib_sprite_init_from_resource(Sprite* sprite, ITU_IdTexture texture_id, SDL_FRect rect)
+{
+	itu_lib_sprite_init(sprite, NULL, itu_sys_rstorage_texture_remap_rect(texture_id, rect));
+	sprite->texture = itu_sys_rstorage_texture_get_ptr(texture_id);
+}
+#endif
+
 SDL_FRect itu_lib_sprite_get_rect(int x, int y, int tile_w, int tile_h)
 {
 	SDL_FRect ret;
@@ -71,6 +95,39 @@ vec2f itu_lib_sprite_get_world_size(SDLContext* context, Sprite* sprite, Transfo
 	return sprite_size_world;
 }
 
+// returns the world-space axis-aligned rect containing the sprite
+// NOTE: rotated sprites get a conservative bound (the square containing every possible rotation around the pivot),
+//       which is cheaper than rotating the 4 corners and good enough for culling
+SDL_FRect itu_lib_sprite_get_world_bounds(SDLContext* context, Sprite* sprite, Transform* transform)
+{
+	vec2f size = itu_lib_sprite_get_world_size(context, sprite, transform);
+	size.x *= SDL_fabsf(transform->scale.x);
+	size.y *= SDL_fabsf(transform->scale.y);
+
+	SDL_FRect ret;
+	if(transform->rotation == 0)
+	{
+		ret.x = transform->position.x - sprite->pivot.x * size.x;
+		ret.y = transform->position.y - sprite->pivot.y * size.y;
+		ret.w = size.x;
+		ret.h = size.y;
+	}
+	else
+	{
+		vec2f extents;
+		extents.x = size.x * SDL_max(sprite->pivot.x, 1 - sprite->pivot.x);
+		extents.y = size.y * SDL_max(sprite->pivot.y, 1 - sprite->pivot.y);
+		float radius = SDL_sqrtf(extents.x * extents.x + extents.y * extents.y);
+
+		ret.x = transform->position.x - radius;
+		ret.y = transform->position.y - radius;
+		ret.w = radius * 2;
+		ret.h = radius * 2;
+	}
+
+	return ret;
+}
+
 void itu_lib_sprite_render(SDLContext* context, Sprite* sprite, Transform* transform)
 {
 	SDL_FRect rect_src = sprite->rect;
@@ -80,8 +137,8 @@ void itu_lib_sprite_render(SDLContext* context, Sprite* sprite, Transform* trans
 	pivot_dst.y = sprite->pivot.y * rect_dst.h;
 
 	sdl_set_texture_tint(sprite->texture, sprite->tint);
-	SDL_RenderTextureRotated(
-		context->renderer,
+	itu_sys_renderstats_render_texture_rotated(
+		context,
 		sprite->texture,
 		&rect_src,
 		&rect_dst,
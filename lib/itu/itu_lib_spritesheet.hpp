@@ -0,0 +1,331 @@
+// itu_lib_spritesheet.hpp
+// sprite sheet regions: named rects in an atlas image, imported from the XML descriptors that come with Kenney sheets
+// (Starling format: `<TextureAtlas imagePath="..."><SubTexture name="..." x="..." y="..." width="..." height="..."/>`)
+//
+// the XML is parsed only once, and turned into a binary region table cached next to it (same name, extension
+// ITU_SPRITESHEET_CACHE_EXTENSION). The table is already laid out as an open addressing hash table keyed by region name id,
+// so following loads just read the file, and lookups are O(1) with no string handling. The cache is imported again when
+// the XML changes (different size or modification time), so artists can repack sheets without touching code
+//
+// usage
+// - `itu_lib_spritesheet_load` with the XML path, then load the image at `itu_lib_spritesheet_get_image_path`
+// - resolve regions once (ie, at init) with `itu_lib_spritesheet_find_region`, and keep the indices around
+// - `itu_lib_spritesheet_get_region_rect` in spawn paths (a plain array access, no hashing nor probing)
+//
+// limitations
+// - only the attributes above are read, trimmed or rotated regions (`frameX`, `rotated`, ...) are not supported
+// - names are not stored. Two names with the same id make the import fail (rename one of them)
+// - the cache is written in the game endianness, and it is not read from asset packs (it is a plain file)
+
+#ifndef ITU_LIB_SPRITESHEET_HPP
+#define ITU_LIB_SPRITESHEET_HPP
+
+#ifndef ITU_UNITY_BUILD
+#include <SDL3/SDL.h>
+#include <itu_lib_fileutils.hpp>
+#endif
+
+#define ITU_SPRITESHEET_MAGIC           0x53555449 // "ITUS"
+#define ITU_SPRITESHEET_VERSION         1
+#define ITU_SPRITESHEET_PATH_MAX        256
+#define ITU_SPRITESHEET_CACHE_EXTENSION ".itusheet"
+
+// cache file layout: header, then `capacity` regions (empty slots have `name_id` 0)
+struct ITU_SpriteSheetHeader
+{
+	Uint32 magic;
+	Uint32 version;
+	Uint32 capacity;           // power of 2
+	Uint32 regions_count;
+	Sint64 source_modify_time; // of the XML the table was imported from
+	Uint64 source_size;
+	char   image_path[ITU_SPRITESHEET_PATH_MAX]; // relative to the working directory (XML paths are relative to the XML)
+};
+
+struct ITU_SpriteSheetRegion
+{
+	Uint32 name_id;
+	Uint16 x;
+	Uint16 y;
+	Uint16 w;
+	Uint16 h;
+};
+
+struct ITU_SpriteSheet
+{
+	void*                        data; // header + table, as stored in the cache file
+	const ITU_SpriteSheetRegion* regions;
+	Uint32                       capacity_mask;
+};
+
+bool        itu_lib_spritesheet_load(ITU_SpriteSheet* sheet, const char* path);
+void        itu_lib_spritesheet_destroy(ITU_SpriteSheet* sheet);
+Uint32      itu_lib_spritesheet_name_id(const char* name);
+bool        itu_lib_spritesheet_has_region(const ITU_SpriteSheet* sheet, Uint32 name_id);
+SDL_FRect   itu_lib_spritesheet_get_rect(const ITU_SpriteSheet* sheet, Uint32 name_id);
+int         itu_lib_spritesheet_find_region(const ITU_SpriteSheet* sheet, const char* name);
+SDL_FRect   itu_lib_spritesheet_get_region_rect(const ITU_SpriteSheet* sheet, int region_idx);
+const char* itu_lib_spritesheet_get_image_path(const ITU_SpriteSheet* sheet);
+int         itu_lib_spritesheet_get_regions_count(const ITU_SpriteSheet* sheet);
+
+#endif // ITU_LIB_SPRITESHEET_HPP
+
+#if (defined ITU_LIB_SPRITESHEET_IMPLEMENTATION) || (defined ITU_UNITY_BUILD)
+
+// FNV-1a. Stored in cache files, so it must never change (or ITU_SPRITESHEET_VERSION must be bumped)
+Uint32 itu_lib_spritesheet_name_id(const char* name)
+{
+	Uint32 ret = 2166136261u;
+	for(const char* c = name; *c; ++c)
+		ret = (ret ^ (Uint8)*c) * 16777619u;
+
+	// 0 marks empty slots
+	return ret == 0 ? 1 : ret;
+}
+
+static const ITU_SpriteSheetRegion* itu_lib_spritesheet_find(const ITU_SpriteSheetRegion* regions, Uint32 capacity_mask, Uint32 name_id)
+{
+	// linear probing, the table is at most half full so there is always an empty slot to stop at
+	for(Uint32 i = name_id & capacity_mask; regions[i].name_id != 0; i = (i + 1) & capacity_mask)
+		if(regions[i].name_id == name_id)
+			return &regions[i];
+
+	return NULL;
+}
+
+// copies the value of attribute `name` of the XML tag in `tag` (NULL-terminated, only the tag itself) in `out`
+static bool itu_lib_spritesheet_xml_attribute(const char* tag, const char* name, char* out, int out_len)
+{
+	char pattern[32];
+	SDL_snprintf(pattern, sizeof(pattern), " %s=\"", name);
+
+	const char* value = SDL_strstr(tag, pattern);
+	if(!value)
+		return false;
+	value += SDL_strlen(pattern);
+
+	const char* value_end = SDL_strchr(value, '"');
+	if(!value_end || value_end - value >= out_len)
+		return false;
+
+	SDL_memcpy(out, value, value_end - value);
+	out[value_end - value] = 0;
+	return true;
+}
+
+// parses the XML at `path` into a cache file image (see `ITU_SpriteSheetHeader`), to free with SDL_free
+static void* itu_lib_spritesheet_import(const char* path, const SDL_PathInfo* path_info, size_t* out_size)
+{
+	char* xml = (char*)SDL_LoadFile(path, NULL);
+	if(!xml)
+	{
+		SDL_Log("ERROR reading sprite sheet '%s': %s", path, SDL_GetError());
+		return NULL;
+	}
+
+	// first pass only counts regions, to size the table
+	Uint32 regions_count = 0;
+	for(const char* ptr = SDL_strstr(xml, "<SubTexture"); ptr; ptr = SDL_strstr(ptr + 1, "<SubTexture"))
+		++regions_count;
+
+	Uint32 capacity = 1;
+	while(capacity < regions_count * 2)
+		capacity *= 2;
+
+	size_t size = sizeof(ITU_SpriteSheetHeader) + capacity * sizeof(ITU_SpriteSheetRegion);
+	ITU_SpriteSheetHeader* header = (ITU_SpriteSheetHeader*)SDL_calloc(1, size);
+	ITU_SpriteSheetRegion* regions = (ITU_SpriteSheetRegion*)(header + 1);
+	header->magic = ITU_SPRITESHEET_MAGIC;
+	header->version = ITU_SPRITESHEET_VERSION;
+	header->capacity = capacity;
+	header->source_modify_time = path_info->modify_time;
+	header->source_size = path_info->size;
+
+	bool ok = true;
+	for(char* tag = SDL_strchr(xml, '<'); tag && ok; tag = SDL_strchr(tag + 1, '<'))
+	{
+		char* tag_end = SDL_strchr(tag, '>');
+		if(!tag_end)
+			break;
+
+		// NOTE: the tag is terminated in place, so that attribute lookups can't run into the next one
+		*tag_end = 0;
+
+		char buf[ITU_SPRITESHEET_PATH_MAX];
+		if(SDL_strncmp(tag, "<TextureAtlas ", 14) == 0 && itu_lib_spritesheet_xml_attribute(tag, "imagePath", buf, sizeof(buf)))
+		{
+			const char* file_name = itu_lib_fileutils_get_file_name(path);
+			SDL_snprintf(header->image_path, ITU_SPRITESHEET_PATH_MAX, "%.*s%s", (int)(file_name - path), path, buf);
+		}
+		else if(SDL_strncmp(tag, "<SubTexture ", 12) == 0)
+		{
+			char name[ITU_SPRITESHEET_PATH_MAX];
+			char x[16], y[16], w[16], h[16];
+			ok =
+				itu_lib_spritesheet_xml_attribute(tag, "name", name, sizeof(name)) &&
+				itu_lib_spritesheet_xml_attribute(tag, "x", x, sizeof(x)) &&
+				itu_lib_spritesheet_xml_attribute(tag, "y", y, sizeof(y)) &&
+				itu_lib_spritesheet_xml_attribute(tag, "width", w, sizeof(w)) &&
+				itu_lib_spritesheet_xml_attribute(tag, "height", h, sizeof(h));
+			if(!ok)
+			{
+				SDL_Log("ERROR importing sprite sheet '%s': malformed region '%s'", path, tag);
+				break;
+			}
+
+			ITU_SpriteSheetRegion region;
+			region.name_id = itu_lib_spritesheet_name_id(name);
+			region.x = (Uint16)SDL_atoi(x);
+			region.y = (Uint16)SDL_atoi(y);
+			region.w = (Uint16)SDL_atoi(w);
+			region.h = (Uint16)SDL_atoi(h);
+
+			if(itu_lib_spritesheet_find(regions, capacity - 1, region.name_id))
+			{
+				SDL_Log("ERROR importing sprite sheet '%s': region '%s' is a duplicate (or its name id collides with another one)", path, name);
+				ok = false;
+				break;
+			}
+
+			Uint32 i = region.name_id & (capacity - 1);
+			while(regions[i].name_id != 0)
+				i = (i + 1) & (capacity - 1);
+			regions[i] = region;
+			++header->regions_count;
+		}
+
+		tag = tag_end;
+	}
+
+	SDL_free(xml);
+
+	if(!ok || header->image_path[0] == 0)
+	{
+		if(ok)
+			SDL_Log("ERROR importing sprite sheet '%s': missing TextureAtlas imagePath", path);
+		SDL_free(header);
+		return NULL;
+	}
+
+	*out_size = size;
+	return header;
+}
+
+static bool itu_lib_spritesheet_cache_is_valid(const void* data, size_t size, const SDL_PathInfo* source_info)
+{
+	if(size < sizeof(ITU_SpriteSheetHeader))
+		return false;
+
+	const ITU_SpriteSheetHeader* header = (const ITU_SpriteSheetHeader*)data;
+	if(header->magic != ITU_SPRITESHEET_MAGIC || header->version != ITU_SPRITESHEET_VERSION)
+		return false;
+	if(header->capacity == 0 || (header->capacity & (header->capacity - 1)) != 0 || header->regions_count >= header->capacity)
+		return false;
+	if(size != sizeof(ITU_SpriteSheetHeader) + (size_t)header->capacity * sizeof(ITU_SpriteSheetRegion))
+		return false;
+	if(SDL_strnlen(header->image_path, ITU_SPRITESHEET_PATH_MAX) == ITU_SPRITESHEET_PATH_MAX)
+		return false;
+
+	// a missing XML is fine (ie, shipping builds only have the cache), otherwise it must be the one the table comes from
+	return !source_info || (header->source_modify_time == source_info->modify_time && header->source_size == (Uint64)source_info->size);
+}
+
+// loads the regions of the XML sprite sheet at `path`, from its cache if up to date (importing and writing it otherwise)
+bool itu_lib_spritesheet_load(ITU_SpriteSheet* sheet, const char* path)
+{
+	*sheet = { 0 };
+
+	// same path, extension replaced
+	char path_cache[ITU_SPRITESHEET_PATH_MAX];
+	const char* extension = SDL_strrchr(itu_lib_fileutils_get_file_name(path), '.');
+	int path_len = extension ? (int)(extension - path) : (int)SDL_strlen(path);
+	SDL_snprintf(path_cache, ITU_SPRITESHEET_PATH_MAX, "%.*s%s", path_len, path, ITU_SPRITESHEET_CACHE_EXTENSION);
+
+	SDL_PathInfo source_info;
+	bool source_exists = SDL_GetPathInfo(path, &source_info);
+
+	size_t size;
+	void* data = SDL_LoadFile(path_cache, &size);
+	if(data && !itu_lib_spritesheet_cache_is_valid(data, size, source_exists ? &source_info : NULL))
+	{
+		SDL_free(data);
+		data = NULL;
+	}
+
+	if(!data && source_exists)
+	{
+		data = itu_lib_spritesheet_import(path, &source_info, &size);
+		if(data && !SDL_SaveFile(path_cache, data, size))
+			SDL_Log("WARNING can't write sprite sheet cache '%s' (it will be imported again next time): %s", path_cache, SDL_GetError());
+	}
+
+	if(!data)
+	{
+		SDL_Log("ERROR loading sprite sheet '%s'", path);
+		return false;
+	}
+
+	const ITU_SpriteSheetHeader* header = (const ITU_SpriteSheetHeader*)data;
+	sheet->data = data;
+	sheet->regions = (const ITU_SpriteSheetRegion*)(header + 1);
+	sheet->capacity_mask = header->capacity - 1;
+
+	return true;
+}
+
+void itu_lib_spritesheet_destroy(ITU_SpriteSheet* sheet)
+{
+	SDL_free(sheet->data);
+	*sheet = { 0 };
+}
+
+bool itu_lib_spritesheet_has_region(const ITU_SpriteSheet* sheet, Uint32 name_id)
+{
+	return sheet->data && itu_lib_spritesheet_find(sheet->regions, sheet->capacity_mask, name_id) != NULL;
+}
+
+// rect of the region in the sheet image, in pixels. Regions not in the sheet are a bug (asserts, and returns an empty rect)
+SDL_FRect itu_lib_spritesheet_get_rect(const ITU_SpriteSheet* sheet, Uint32 name_id)
+{
+	const ITU_SpriteSheetRegion* region = sheet->data ? itu_lib_spritesheet_find(sheet->regions, sheet->capacity_mask, name_id) : NULL;
+	SDL_assert(region && "sprite sheet region not found");
+	if(!region)
+		return SDL_FRect { 0 };
+
+	return SDL_FRect { (float)region->x, (float)region->y, (float)region->w, (float)region->h };
+}
+
+// index of the region in the table, for `itu_lib_spritesheet_get_region_rect`. Regions not in the sheet are a bug (asserts,
+// and returns -1). Indices are only valid for the sheet they come from, and until it is loaded again
+int itu_lib_spritesheet_find_region(const ITU_SpriteSheet* sheet, const char* name)
+{
+	const ITU_SpriteSheetRegion* region = sheet->data ? itu_lib_spritesheet_find(sheet->regions, sheet->capacity_mask, itu_lib_spritesheet_name_id(name)) : NULL;
+	SDL_assert(region && "sprite sheet region not found");
+	if(!region)
+		return -1;
+
+	return (int)(region - sheet->regions);
+}
+
+// rect of the region at `region_idx` (from `itu_lib_spritesheet_find_region`), in pixels. -1 returns an empty rect
+SDL_FRect itu_lib_spritesheet_get_region_rect(const ITU_SpriteSheet* sheet, int region_idx)
+{
+	if(region_idx == -1)
+		return SDL_FRect { 0 };
+
+	SDL_assert((Uint32)region_idx <= sheet->capacity_mask);
+	const ITU_SpriteSheetRegion* region = &sheet->regions[region_idx];
+	return SDL_FRect { (float)region->x, (float)region->y, (float)region->w, (float)region->h };
+}
+
+const char* itu_lib_spritesheet_get_image_path(const ITU_SpriteSheet* sheet)
+{
+	return ((const ITU_SpriteSheetHeader*)sheet->data)->image_path;
+}
+
+int itu_lib_spritesheet_get_regions_count(const ITU_SpriteSheet* sheet)
+{
+	return sheet->data ? (int)((const ITU_SpriteSheetHeader*)sheet->data)->regions_count : 0;
+}
+
+#endif // (defined ITU_LIB_SPRITESHEET_IMPLEMENTATION) || (defined ITU_UNITY_BUILD)
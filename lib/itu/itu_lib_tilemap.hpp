@@ -0,0 +1,288 @@
+// itu_lib_tilemap.hpp
+// chunked tilemap
+// the map is split in chunks of TILEMAP_CHUNK_SIZE x TILEMAP_CHUNK_SIZE tiles. Each chunk is rendered once into a target texture
+// ("baked") and then drawn as a single quad (through the sprite batcher in `itu_sys_render`) every frame.
+// Changing a tile only marks its chunk as dirty, and only dirty chunks are baked again
+//
+// conventions (same as the tilemap in ES03)
+// - tile rows are stored with the y-axis pointing up (row 0 is the bottom one)
+// - tile (x, y) is centered in `transform.position + tile_size_world * (x, y)`
+// - tile ids are indices in the tileset texture (row-major, `tileset_num_cols` tiles per row). TILEMAP_TILE_EMPTY leaves the tile transparent
+//
+// limitations
+// - transform rotation is ignored
+// - chunk textures are owned by the tilemap, call `itu_lib_tilemap_destroy` to release them
+// - baking uses the SDL renderer, so it is skipped in `itu_sys_render` snapshot mode (simulation thread). Dirty chunks keep
+//   their previous content until they are baked again (see `itu_lib_tilemap_bake_all`)
+// - tilesets packed in an atlas page must go through `itu_lib_tilemap_init_from_resource`
+
+#ifndef ITU_LIB_TILEMAP_HPP
+#define ITU_LIB_TILEMAP_HPP
+
+#ifndef ITU_UNITY_BUILD
+#include <SDL3/SDL.h>
+#include <itu_common.hpp>
+#include <itu_lib_engine.hpp>
+#include <itu_lib_sprite.hpp>
+#include <itu_sys_render.hpp>
+#endif
+
+#define TILEMAP_CHUNK_SIZE 32 // in tiles, per side
+#define TILEMAP_TILE_EMPTY -1
+
+struct TilemapChunk
+{
+	SDL_Texture* texture; // created on first bake
+	bool         dirty;
+};
+
+struct Tilemap
+{
+	SDL_Texture* tileset;
+	vec2f        tileset_offset; // where the tileset image starts in `tileset` (not zero if packed in an atlas page)
+	int          tileset_num_cols;
+	int          tile_size; // in texture pixels
+
+	int num_cols;
+	int num_rows;
+	int* tile_ids;
+
+	int chunks_num_cols;
+	int chunks_num_rows;
+	TilemapChunk* chunks;
+
+	int layer; // same meaning as `Sprite::layer`
+};
+
+void itu_lib_tilemap_init(Tilemap* tilemap, SDL_Texture* tileset, int tileset_num_cols, int tile_size, int num_cols, int num_rows);
+// resource storage is only compiled in unity builds
+#ifdef ITU_UNITY_BUILD
+void itu_lib_tilemap_init_from_resource(Tilemap* tilemap, ITU_IdTexture tileset_id, int tileset_num_cols, int tile_size, int num_cols, int num_rows);
+#endif
+void itu_lib_tilemap_destroy(Tilemap* tilemap);
+int  itu_lib_tilemap_get_tile(Tilemap* tilemap, int x, int y);
+void itu_lib_tilemap_set_tile(Tilemap* tilemap, int x, int y, int tile_id);
+void itu_lib_tilemap_set_dirty_all(Tilemap* tilemap);
+vec2f itu_lib_tilemap_get_tile_world_size(Tilemap* tilemap, Transform* transform);
+void itu_lib_tilemap_bake_chunk(SDLContext* context, Tilemap* tilemap, int chunk_x, int chunk_y);
+void itu_lib_tilemap_bake_all(SDLContext* context, Tilemap* tilemap);
+void itu_lib_tilemap_render(SDLContext* context, Tilemap* tilemap, Transform* transform);
+
+#endif // ITU_LIB_TILEMAP_HPP
+
+#if (defined ITU_LIB_TILEMAP_IMPLEMENTATION) || (defined ITU_UNITY_BUILD)
+
+// allocates an empty tilemap
+void itu_lib_tilemap_init(Tilemap* tilemap, SDL_Texture* tileset, int tileset_num_cols, int tile_size, int num_cols, int num_rows)
+{
+	SDL_assert(tileset_num_cols > 0 && tile_size > 0 && num_cols > 0 && num_rows > 0);
+#ifdef ITU_UNITY_BUILD
+	SDL_assert(!itu_sys_rstorage_texture_is_atlas_page(tileset) && "packed tileset, use itu_lib_tilemap_init_from_resource");
+#endif
+
+	tilemap->tileset = tileset;
+	tilemap->tileset_offset = VEC2F_ZERO;
+	tilemap->tileset_num_cols = tileset_num_cols;
+	tilemap->tile_size = tile_size;
+	tilemap->num_cols = num_cols;
+	tilemap->num_rows = num_rows;
+	tilemap->layer = 0;
+
+	tilemap->tile_ids = (int*)SDL_malloc(num_cols * num_rows * sizeof(int));
+	for(int i = 0; i < num_cols * num_rows; ++i)
+		tilemap->tile_ids[i] = TILEMAP_TILE_EMPTY;
+
+	tilemap->chunks_num_cols = (num_cols + TILEMAP_CHUNK_SIZE - 1) / TILEMAP_CHUNK_SIZE;
+	tilemap->chunks_num_rows = (num_rows + TILEMAP_CHUNK_SIZE - 1) / TILEMAP_CHUNK_SIZE;
+	tilemap->chunks = (TilemapChunk*)SDL_calloc(tilemap->chunks_num_cols * tilemap->chunks_num_rows, sizeof(TilemapChunk));
+	itu_lib_tilemap_set_dirty_all(tilemap);
+}
+
+#ifdef ITU_UNITY_BUILD
+// same as `itu_lib_tilemap_init`, but takes a resource storage texture, that can be packed in an atlas page
+void itu_lib_tilemap_init_from_resource(Tilemap* tilemap, ITU_IdTexture tileset_id, int tileset_num_cols, int tile_size, int num_cols, int num_rows)
+{
+	itu_lib_tilemap_init(tilemap, NULL, tileset_num_cols, tile_size, num_cols, num_rows);
+
+	SDL_FRect rect_tileset = itu_sys_rstorage_texture_get_rect(tileset_id);
+	tilemap->tileset = itu_sys_rstorage_texture_get_ptr(tileset_id);
+	tilemap->tileset_offset = vec2f{ rect_tileset.x, rect_tileset.y };
+}
+#endif
+
+void itu_lib_tilemap_destroy(Tilemap* tilemap)
+{
+	for(int i = 0; i < tilemap->chunks_num_cols * tilemap->chunks_num_rows; ++i)
+		if(tilemap->chunks[i].texture)
+			SDL_DestroyTexture(tilemap->chunks[i].texture);
+
+	SDL_free(tilemap->chunks);
+	SDL_free(tilemap->tile_ids);
+	tilemap->chunks = NULL;
+	tilemap->tile_ids = NULL;
+}
+
+int itu_lib_tilemap_get_tile(Tilemap* tilemap, int x, int y)
+{
+	SDL_assert(x >= 0 && x < tilemap->num_cols && y >= 0 && y < tilemap->num_rows);
+	return tilemap->tile_ids[y * tilemap->num_cols + x];
+}
+
+void itu_lib_tilemap_set_tile(Tilemap* tilemap, int x, int y, int tile_id)
+{
+	SDL_assert(x >= 0 && x < tilemap->num_cols && y >= 0 && y < tilemap->num_rows);
+
+	int* tile = &tilemap->tile_ids[y * tilemap->num_cols + x];
+	if(*tile == tile_id)
+		return;
+
+	*tile = tile_id;
+	tilemap->chunks[(y / TILEMAP_CHUNK_SIZE) * tilemap->chunks_num_cols + x / TILEMAP_CHUNK_SIZE].dirty = true;
+}
+
+// forces a re-bake of the whole map (ie, after changing the tileset texture, or writing `tile_ids` directly)
+void itu_lib_tilemap_set_dirty_all(Tilemap* tilemap)
+{
+	for(int i = 0; i < tilemap->chunks_num_cols * tilemap->chunks_num_rows; ++i)
+		tilemap->chunks[i].dirty = true;
+}
+
+vec2f itu_lib_tilemap_get_tile_world_size(Tilemap* tilemap, Transform* transform)
+{
+	vec2f ret;
+	ret.x = transform->scale.x * (tilemap->tile_size / (float)TEXTURE_PIXELS_PER_UNIT);
+	ret.y = transform->scale.y * (tilemap->tile_size / (float)TEXTURE_PIXELS_PER_UNIT);
+	return ret;
+}
+
+void itu_lib_tilemap_bake_chunk(SDLContext* context, Tilemap* tilemap, int chunk_x, int chunk_y)
+{
+	TilemapChunk* chunk = &tilemap->chunks[chunk_y * tilemap->chunks_num_cols + chunk_x];
+
+	const int chunk_size_px = TILEMAP_CHUNK_SIZE * tilemap->tile_size;
+	if(!chunk->texture)
+	{
+		chunk->texture = SDL_CreateTexture(context->renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET, chunk_size_px, chunk_size_px);
+		if(!chunk->texture)
+		{
+			SDL_Log("ERROR creating tilemap chunk texture: %s", SDL_GetError());
+			return;
+		}
+
+		SDL_ScaleMode scale_mode;
+		SDL_GetTextureScaleMode(tilemap->tileset, &scale_mode);
+		SDL_SetTextureScaleMode(chunk->texture, scale_mode);
+		SDL_SetTextureBlendMode(chunk->texture, SDL_BLENDMODE_BLEND);
+	}
+
+	// NOTE: render target, viewport and scale are per-target state in SDL3, so restoring the target restores everything else
+	SDL_Texture* target_prev = SDL_GetRenderTarget(context->renderer);
+	SDL_BlendMode blend_mode_prev;
+	SDL_GetTextureBlendMode(tilemap->tileset, &blend_mode_prev);
+
+	SDL_SetRenderTarget(context->renderer, chunk->texture);
+	SDL_SetRenderDrawColor(context->renderer, 0, 0, 0, 0);
+	SDL_RenderClear(context->renderer);
+
+	// copy tiles as they are (alpha included), blending will happen when the chunk itself is drawn
+	SDL_SetTextureBlendMode(tilemap->tileset, SDL_BLENDMODE_NONE);
+	sdl_set_texture_tint(tilemap->tileset, COLOR_WHITE);
+
+	int x_beg = chunk_x * TILEMAP_CHUNK_SIZE;
+	int y_beg = chunk_y * TILEMAP_CHUNK_SIZE;
+	int x_end = SDL_min(x_beg + TILEMAP_CHUNK_SIZE, tilemap->num_cols);
+	int y_end = SDL_min(y_beg + TILEMAP_CHUNK_SIZE, tilemap->num_rows);
+	for(int y = y_beg; y < y_end; ++y)
+	{
+		for(int x = x_beg; x < x_end; ++x)
+		{
+			int tile_id = tilemap->tile_ids[y * tilemap->num_cols + x];
+			if(tile_id == TILEMAP_TILE_EMPTY)
+				continue;
+
+			SDL_FRect rect_src = itu_lib_sprite_get_rect(tile_id % tilemap->tileset_num_cols, tile_id / tilemap->tileset_num_cols, tilemap->tile_size, tilemap->tile_size);
+			rect_src.x += tilemap->tileset_offset.x;
+			rect_src.y += tilemap->tileset_offset.y;
+
+			// tilemap y-axis points up, texture y-axis points down
+			SDL_FRect rect_dst;
+			rect_dst.w = tilemap->tile_size;
+			rect_dst.h = tilemap->tile_size;
+			rect_dst.x = (x - x_beg) * tilemap->tile_size;
+			rect_dst.y = (TILEMAP_CHUNK_SIZE - 1 - (y - y_beg)) * tilemap->tile_size;
+
+			SDL_RenderTexture(context->renderer, tilemap->tileset, &rect_src, &rect_dst);
+		}
+	}
+
+	SDL_SetTextureBlendMode(tilemap->tileset, blend_mode_prev);
+	SDL_SetRenderTarget(context->renderer, target_prev);
+
+	chunk->dirty = false;
+}
+
+// bakes all dirty chunks, visible or not
+void itu_lib_tilemap_bake_all(SDLContext* context, Tilemap* tilemap)
+{
+	for(int chunk_y = 0; chunk_y < tilemap->chunks_num_rows; ++chunk_y)
+		for(int chunk_x = 0; chunk_x < tilemap->chunks_num_cols; ++chunk_x)
+			if(tilemap->chunks[chunk_y * tilemap->chunks_num_cols + chunk_x].dirty)
+				itu_lib_tilemap_bake_chunk(context, tilemap, chunk_x, chunk_y);
+}
+
+// bakes dirty chunks and queues visible chunks for rendering in the sprite batcher
+void itu_lib_tilemap_render(SDLContext* context, Tilemap* tilemap, Transform* transform)
+{
+	vec2f tile_size_world = itu_lib_tilemap_get_tile_world_size(tilemap, transform);
+	vec2f chunk_size_world = tile_size_world * TILEMAP_CHUNK_SIZE;
+
+	// bottom-left corner of the map (tiles are centered on their coordinates)
+	vec2f origin = transform->position - tile_size_world * 0.5f;
+
+	SDL_FRect rect_view = camera_get_world_rect(context, context->camera_active);
+
+	for(int chunk_y = 0; chunk_y < tilemap->chunks_num_rows; ++chunk_y)
+	{
+		for(int chunk_x = 0; chunk_x < tilemap->chunks_num_cols; ++chunk_x)
+		{
+			TilemapChunk* chunk = &tilemap->chunks[chunk_y * tilemap->chunks_num_cols + chunk_x];
+
+			// tiles actually used in this chunk (border chunks can be partially filled)
+			int tiles_w = SDL_min(TILEMAP_CHUNK_SIZE, tilemap->num_cols - chunk_x * TILEMAP_CHUNK_SIZE);
+			int tiles_h = SDL_min(TILEMAP_CHUNK_SIZE, tilemap->num_rows - chunk_y * TILEMAP_CHUNK_SIZE);
+
+			SDL_FRect rect_chunk;
+			rect_chunk.x = origin.x + chunk_x * chunk_size_world.x;
+			rect_chunk.y = origin.y + chunk_y * chunk_size_world.y;
+			rect_chunk.w = tiles_w * tile_size_world.x;
+			rect_chunk.h = tiles_h * tile_size_world.y;
+			if(!SDL_HasRectIntersectionFloat(&rect_view, &rect_chunk))
+				continue;
+
+			// NOTE: we bake lazily, so offscreen chunks are not updated until they become visible
+			if(chunk->dirty && !itu_sys_render_snapshot_is_enabled())
+				itu_lib_tilemap_bake_chunk(context, tilemap, chunk_x, chunk_y);
+			if(!chunk->texture)
+				continue;
+
+			Sprite sprite;
+			itu_lib_sprite_init(&sprite, chunk->texture, SDL_FRect {
+				0,
+				(float)((TILEMAP_CHUNK_SIZE - tiles_h) * tilemap->tile_size),
+				(float)(tiles_w * tilemap->tile_size),
+				(float)(tiles_h * tilemap->tile_size)
+			});
+			sprite.pivot = VEC2F_ZERO;
+			sprite.layer = tilemap->layer;
+
+			Transform transform_chunk;
+			transform_chunk.position = vec2f { rect_chunk.x, rect_chunk.y };
+			transform_chunk.scale = transform->scale;
+			transform_chunk.rotation = 0;
+
+			itu_sys_render_sprite_push(&sprite, &transform_chunk);
+		}
+	}
+}
+
+#endif // (defined ITU_LIB_TILEMAP_IMPLEMENTATION) || (defined ITU_UNITY_BUILD)
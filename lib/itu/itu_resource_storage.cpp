@@ -3,185 +3,1977 @@
 
 #include <SDL3/SDL.h>
 #include <itu_common.hpp>
+#include <itu_lib_fileutils.hpp>
+#include <itu_lib_assetpack.hpp>
+#include <itu_sys_jobs.hpp>
 #include <SDL3_mixer/SDL_mixer.h>
 #include <SDL3_ttf/SDL_ttf.h>
 #include <stb_ds.h>
+#include <stb_image.h>
 #include <imgui/imgui.h>
+#include <imgui/imstb_rectpack.h>
 #endif
 
+#if (defined ENABLE_DIAGNOSTICS) && (defined SDL_PLATFORM_LINUX)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+// empty pixels left on the right and bottom of every image packed in an atlas page, to avoid bleeding when filtering
+#define ATLAS_PAGE_PADDING 2
+
+// streamed textures are uploaded in bands of (about) this many bytes, the upload budget is checked between bands
+#define TEXTURE_STREAM_BAND_BYTES (256 * 1024)
+#define TEXTURE_STREAM_PLACEHOLDER_COLOR 0xFF, 0x00, 0xFF, 0x80
+
+#define CACHE_KEY_LENGTH_MAX 512
+
+// how often the hot-reload thread wakes up to check for changes (or to quit)
+#define HOTRELOAD_POLL_INTERVAL_MS 250
+
+// resource ids are generational handles: the low bits are the index of the slot in the storage array, the high bits
+// the generation of the slot (incremented every time the slot is freed), so that stale ids can be detected
+#define RESOURCE_ID_INDEX_BITS     20
+#define RESOURCE_ID_INDEX_MASK     ((1u << RESOURCE_ID_INDEX_BITS) - 1)
+#define RESOURCE_ID_GENERATION_MAX ((1u << (32 - RESOURCE_ID_INDEX_BITS)) - 2) // so that -1 is never a valid id
+
+#define resource_id_make(index, generation) (((generation) << RESOURCE_ID_INDEX_BITS) | (index))
+#define resource_id_index(id)               ((Uint32)(id) & RESOURCE_ID_INDEX_MASK)
+#define resource_id_generation(id)          ((Uint32)(id) >> RESOURCE_ID_INDEX_BITS)
+
+struct ResourceSlot
+{
+	Uint32 generation;
+	bool   used;
+};
+
+// reference counting and caching info, common to all resource types
+// NOTE: resources registered with `*_add` don't have a cache key. They are owned by the caller, so they are never destroyed
+struct ResourceCacheInfo
+{
+	char*  key;          // normalized path + variant (ie, scale mode or font size), NULL if not loaded from a file
+	int    refcount;
+	size_t bytes;        // estimated memory used
+	Uint64 release_tick; // when `refcount` went to 0, for LRU eviction
+};
+
+struct TextureData
+{
+	SDL_Texture*    texture;
+	SDL_FRect       rect;       // region of `texture` used by this resource (the whole texture, unless packed in an atlas page)
+	int             atlas_page; // -1 if not packed
+	SDL_PixelFormat format;     // format of `texture`, RGBA32 unless a 16 bit one was allowed (see `ITU_TextureQuality`)
+
+	ResourceSlot      slot;
+	ResourceCacheInfo cache;
+	char*             debug_name;
+};
+
+// a single texture shared by many small images, so that sprites using them can be batched together
+// NOTE: pages are heap-allocated because `stbrp_context` keeps pointers to itself, so it can't be moved around by stbds_arrput
+struct AtlasPage
+{
+	SDL_Texture*    texture;
+	SDL_ScaleMode   scale_mode; // images with different scale modes can't share a page
+	SDL_PixelFormat format;     // same for formats
+	stbrp_context packer;
+	stbrp_node*   packer_nodes;
+};
+
+enum TextureStreamState
+{
+	TEXTURE_STREAM_STATE_DECODING,
+	TEXTURE_STREAM_STATE_DECODED,
+	TEXTURE_STREAM_STATE_FAILED,
+};
+
+// a texture being loaded asynchronously. Decoded by the loader thread, uploaded by the render thread
+struct TextureStreamRequest
+{
+	ITU_IdTexture  id;
+	char*          path;
+	SDL_Texture*   texture;     // final texture (own texture or atlas page), already returned to the user. NULL if released
+	SDL_Rect       rect_upload; // where the image goes in `texture`
+	SDL_AtomicInt  state;
+	unsigned char* pixels;      // written by the loader thread, valid once DECODED
+	int            rows_uploaded;
+};
+
+// a watched file that changed on disk, already decoded by the hot-reload thread
+struct HotReloadResult
+{
+	char*          path;   // normalized
+	unsigned char* pixels; // RGBA32, NULL if not an image (ie, fonts, that are reopened by the render thread)
+	int            w;
+	int            h;
+};
+
+enum ManifestEntryState
+{
+	MANIFEST_ENTRY_STATE_PENDING,   // waiting for a worker
+	MANIFEST_ENTRY_STATE_DECODED,   // ready to be registered (and uploaded) by the render thread
+	MANIFEST_ENTRY_STATE_DONE,
+};
+
+// an asset declared with `itu_sys_rstorage_manifest_add_*`
+struct ManifestEntry
+{
+	ITU_AssetType type;
+	char*         path;
+	float         variant;  // scale mode, font size or audio policy
+	bool          cached;   // already loaded when the manifest started, nothing to decode
+	Uint32        id;       // -1 until done, or if loading failed
+	SDL_AtomicInt state;
+
+	// decoded by workers
+	unsigned char*  pixels;
+	int             w;
+	int             h;
+	SDL_PixelFormat pixels_format;
+	bool            pixels_from_pack;
+	MIX_Audio*      audio;
+};
+
+struct AudioClipData
+{
+	MIX_Audio*          audio;
+	ITU_AudioLoadPolicy policy;
+
+	ResourceSlot      slot;
+	ResourceCacheInfo cache;
+	char*             debug_name;
+};
+
+struct FontData
+{
+	TTF_Font* font;
+
+	ResourceSlot      slot;
+	ResourceCacheInfo cache;
+	char*             debug_name;
+};
+
+struct ITU_ResourceStorageContext
+{
+	// slot arrays, indexed by `resource_id_index`
+	stbds_arr(TextureData) storage_texture;
+	stbds_arr(FontData)      storage_font;
+	stbds_arr(AudioClipData) storage_audio;
+	stbds_arr(Uint32)        slots_free_texture;
+	stbds_arr(Uint32)        slots_free_font;
+	stbds_arr(Uint32)        slots_free_audio;
+
+	// reverse lookup. Atlas pages are shared by many textures, in that case the map points to one of them
+	stbds_hm(SDL_Texture*, ITU_IdTexture) ptr_to_id_texture;
+	stbds_hm(TTF_Font*   , ITU_IdFont)    ptr_to_id_font;
+
+	// cache, maps keys (see `ResourceCacheInfo`) to loaded resources
+	stbds_sm(char*, ITU_IdTexture) cache_texture;
+	stbds_sm(char*, ITU_IdFont)    cache_font;
+	stbds_sm(char*, ITU_IdAudio)   cache_audio;
+	size_t cache_bytes;
+	size_t cache_budget;
+	Uint64 cache_tick;
+
+	// per-asset texture quality (normalized path -> quality), FULL if not set
+	stbds_sm(char*, ITU_TextureQuality) texture_quality;
+
+	// mounted asset pack, maps normalized paths to entries
+	const void* pack_data;
+	size_t      pack_size;
+	stbds_sm(char*, const ITU_AssetPackEntry*) pack_entries;
+
+	// hot reload (ENABLE_DIAGNOSTICS builds only)
+	SDL_Thread*                  hotreload_thread;
+	SDL_Mutex*                   hotreload_mutex;
+	SDL_AtomicInt                hotreload_quit;
+	stbds_sm(char*, SDL_Time)    hotreload_paths;   // watched files (normalized) -> last modification time, protected by `hotreload_mutex`
+	stbds_arr(HotReloadResult)   hotreload_results; // protected by `hotreload_mutex`
+	stbds_arr(SDL_Texture*)      hotreload_retired_textures;
+	stbds_arr(TTF_Font*)         hotreload_retired_fonts;
+#ifdef SDL_PLATFORM_LINUX
+	int                          hotreload_inotify_fd;
+	stbds_hm(int, char*)         hotreload_inotify_dirs; // watch descriptor -> directory, protected by `hotreload_mutex`
+#endif
+
+	// manifest preloading
+	stbds_arr(ManifestEntry) manifest_entries;
+	ITU_JobTask*             manifest_task;
+	MIX_Mixer*               manifest_mixer;
+	int                      manifest_done_count;
+	bool                     manifest_loading;
+
+	// atlas packing (disabled if `atlas_page_size` is 0)
+	int atlas_page_size;
+	int atlas_max_image_size;
+	stbds_arr(AtlasPage*) atlas_pages;
+
+	// texture streaming
+	stbds_arr(TextureStreamRequest*) stream_requests;     // all requests not uploaded yet, in load order (render thread only)
+	stbds_arr(TextureStreamRequest*) stream_decode_queue; // protected by `stream_mutex`
+	SDL_Thread*    stream_thread;
+	SDL_Mutex*     stream_mutex;
+	SDL_Condition* stream_condition;
+	bool           stream_quit;                           // protected by `stream_mutex`
+};
+ITU_ResourceStorageContext ctx_rstorage;
+
+// =====================================================================================
+// slots
+// =====================================================================================
+// returns NULL if the id is invalid or stale
+static TextureData* itu_sys_rstorage_texture_data_get(ITU_IdTexture id)
+{
+	Uint32 index = resource_id_index(id);
+	if(index >= (Uint32)stbds_arrlen(ctx_rstorage.storage_texture))
+		return NULL;
+
+	TextureData* data = &ctx_rstorage.storage_texture[index];
+	if(!data->slot.used || data->slot.generation != resource_id_generation(id))
+		return NULL;
+
+	return data;
+}
+
+static FontData* itu_sys_rstorage_font_data_get(ITU_IdFont id)
+{
+	Uint32 index = resource_id_index(id);
+	if(index >= (Uint32)stbds_arrlen(ctx_rstorage.storage_font))
+		return NULL;
+
+	FontData* data = &ctx_rstorage.storage_font[index];
+	if(!data->slot.used || data->slot.generation != resource_id_generation(id))
+		return NULL;
+
+	return data;
+}
+
+static AudioClipData* itu_sys_rstorage_audio_data_get(ITU_IdAudio id)
+{
+	Uint32 index = resource_id_index(id);
+	if(index >= (Uint32)stbds_arrlen(ctx_rstorage.storage_audio))
+		return NULL;
+
+	AudioClipData* data = &ctx_rstorage.storage_audio[index];
+	if(!data->slot.used || data->slot.generation != resource_id_generation(id))
+		return NULL;
+
+	return data;
+}
+
+// copies `data` in a free slot (reusing freed ones first) and returns its id
+static ITU_IdTexture itu_sys_rstorage_texture_slot_alloc(TextureData* data)
+{
+	Uint32 index;
+	if(stbds_arrlen(ctx_rstorage.slots_free_texture) > 0)
+	{
+		index = stbds_arrpop(ctx_rstorage.slots_free_texture);
+		data->slot.generation = ctx_rstorage.storage_texture[index].slot.generation;
+		ctx_rstorage.storage_texture[index] = *data;
+	}
+	else
+	{
+		SDL_assert(stbds_arrlen(ctx_rstorage.storage_texture) <= RESOURCE_ID_INDEX_MASK);
+		index = stbds_arrlen(ctx_rstorage.storage_texture);
+		data->slot.generation = 0;
+		stbds_arrput(ctx_rstorage.storage_texture, *data);
+	}
+	ctx_rstorage.storage_texture[index].slot.used = true;
+
+	ITU_IdTexture id = resource_id_make(index, data->slot.generation);
+	if(stbds_hmgeti(ctx_rstorage.ptr_to_id_texture, data->texture) == -1)
+		stbds_hmput(ctx_rstorage.ptr_to_id_texture, data->texture, id);
+
+	return id;
+}
+
+static ITU_IdFont itu_sys_rstorage_font_slot_alloc(FontData* data)
+{
+	Uint32 index;
+	if(stbds_arrlen(ctx_rstorage.slots_free_font) > 0)
+	{
+		index = stbds_arrpop(ctx_rstorage.slots_free_font);
+		data->slot.generation = ctx_rstorage.storage_font[index].slot.generation;
+		ctx_rstorage.storage_font[index] = *data;
+	}
+	else
+	{
+		SDL_assert(stbds_arrlen(ctx_rstorage.storage_font) <= RESOURCE_ID_INDEX_MASK);
+		index = stbds_arrlen(ctx_rstorage.storage_font);
+		data->slot.generation = 0;
+		stbds_arrput(ctx_rstorage.storage_font, *data);
+	}
+	ctx_rstorage.storage_font[index].slot.used = true;
+
+	ITU_IdFont id = resource_id_make(index, data->slot.generation);
+	if(stbds_hmgeti(ctx_rstorage.ptr_to_id_font, data->font) == -1)
+		stbds_hmput(ctx_rstorage.ptr_to_id_font, data->font, id);
+
+	return id;
+}
+
+static ITU_IdAudio itu_sys_rstorage_audio_slot_alloc(AudioClipData* data)
+{
+	Uint32 index;
+	if(stbds_arrlen(ctx_rstorage.slots_free_audio) > 0)
+	{
+		index = stbds_arrpop(ctx_rstorage.slots_free_audio);
+		data->slot.generation = ctx_rstorage.storage_audio[index].slot.generation;
+		ctx_rstorage.storage_audio[index] = *data;
+	}
+	else
+	{
+		SDL_assert(stbds_arrlen(ctx_rstorage.storage_audio) <= RESOURCE_ID_INDEX_MASK);
+		index = stbds_arrlen(ctx_rstorage.storage_audio);
+		data->slot.generation = 0;
+		stbds_arrput(ctx_rstorage.storage_audio, *data);
+	}
+	ctx_rstorage.storage_audio[index].slot.used = true;
+
+	return resource_id_make(index, data->slot.generation);
+}
+
+// invalidates the id (and all its copies), the slot will be reused by the next alloc
+static void itu_sys_rstorage_texture_slot_free(ITU_IdTexture id)
+{
+	Uint32 index = resource_id_index(id);
+	TextureData* data = &ctx_rstorage.storage_texture[index];
+	SDL_Texture* texture = data->texture;
+
+	SDL_free(data->debug_name);
+	data->debug_name = NULL;
+	data->slot.used = false;
+	data->slot.generation = data->slot.generation == RESOURCE_ID_GENERATION_MAX ? 0 : data->slot.generation + 1;
+	stbds_arrput(ctx_rstorage.slots_free_texture, index);
+
+	int map_loc = stbds_hmgeti(ctx_rstorage.ptr_to_id_texture, texture);
+	if(map_loc != -1 && ctx_rstorage.ptr_to_id_texture[map_loc].value == id)
+	{
+		stbds_hmdel(ctx_rstorage.ptr_to_id_texture, texture);
+
+		// other images may still be packed in the same atlas page (this is the only linear scan, and only happens for atlas pages)
+		for(int i = 0; i < stbds_arrlen(ctx_rstorage.storage_texture); ++i)
+		{
+			TextureData* other = &ctx_rstorage.storage_texture[i];
+			if(other->slot.used && other->texture == texture)
+			{
+				stbds_hmput(ctx_rstorage.ptr_to_id_texture, texture, resource_id_make(i, other->slot.generation));
+				break;
+			}
+		}
+	}
+}
+
+static void itu_sys_rstorage_font_slot_free(ITU_IdFont id)
+{
+	Uint32 index = resource_id_index(id);
+	FontData* data = &ctx_rstorage.storage_font[index];
+
+	SDL_free(data->debug_name);
+	data->debug_name = NULL;
+	data->slot.used = false;
+	data->slot.generation = data->slot.generation == RESOURCE_ID_GENERATION_MAX ? 0 : data->slot.generation + 1;
+	stbds_arrput(ctx_rstorage.slots_free_font, index);
+
+	int map_loc = stbds_hmgeti(ctx_rstorage.ptr_to_id_font, data->font);
+	if(map_loc != -1 && ctx_rstorage.ptr_to_id_font[map_loc].value == id)
+		stbds_hmdel(ctx_rstorage.ptr_to_id_font, data->font);
+}
+
+static void itu_sys_rstorage_audio_slot_free(ITU_IdAudio id)
+{
+	Uint32 index = resource_id_index(id);
+	AudioClipData* data = &ctx_rstorage.storage_audio[index];
+
+	SDL_free(data->debug_name);
+	data->debug_name = NULL;
+	data->slot.used = false;
+	data->slot.generation = data->slot.generation == RESOURCE_ID_GENERATION_MAX ? 0 : data->slot.generation + 1;
+	stbds_arrput(ctx_rstorage.slots_free_audio, index);
+}
+
+// =====================================================================================
+// asset pack
+// =====================================================================================
+// memory-maps an asset pack (see `itu_lib_assetpack.hpp`). From now on, textures and fonts found in the pack are loaded
+// from the mapped memory (images already decoded) instead of from their files.
+// Returns false if the pack is missing or invalid, in which case everything keeps loading from files.
+// NOTE: fonts keep reading from the mapped memory, so the pack must stay mounted as long as fonts loaded from it are in use
+bool itu_sys_rstorage_pack_mount(const char* path)
+{
+	itu_sys_rstorage_pack_unmount();
+
+	size_t size;
+	const void* data = itu_lib_fileutils_map_file(path, &size);
+	if(!data)
+	{
+		SDL_Log("no asset pack found in '%s', loading from files", path);
+		return false;
+	}
+
+	int entries_count;
+	const ITU_AssetPackEntry* entries = itu_lib_assetpack_get_entries(data, size, &entries_count);
+	if(!entries)
+	{
+		SDL_Log("WARNING invalid or outdated asset pack '%s', loading from files", path);
+		itu_lib_fileutils_unmap_file(data, size);
+		return false;
+	}
+
+	ctx_rstorage.pack_data = data;
+	ctx_rstorage.pack_size = size;
+
+	// NOTE: normalized again, so that lookups match even if the pack has been built on a different platform
+	stbds_sh_new_strdup(ctx_rstorage.pack_entries);
+	for(int i = 0; i < entries_count; ++i)
+	{
+		char path_normalized[CACHE_KEY_LENGTH_MAX];
+		itu_lib_fileutils_normalize_path(entries[i].path, path_normalized, CACHE_KEY_LENGTH_MAX);
+		stbds_shput(ctx_rstorage.pack_entries, path_normalized, &entries[i]);
+	}
+
+	return true;
+}
+
+void itu_sys_rstorage_pack_unmount()
+{
+	stbds_shfree(ctx_rstorage.pack_entries);
+	itu_lib_fileutils_unmap_file(ctx_rstorage.pack_data, ctx_rstorage.pack_size);
+	ctx_rstorage.pack_data = NULL;
+	ctx_rstorage.pack_size = 0;
+}
+
+// returns NULL if there is no pack mounted, or the file is not in it
+static const ITU_AssetPackEntry* itu_sys_rstorage_pack_find(const char* path, ITU_AssetPackEntryType type)
+{
+	if(!ctx_rstorage.pack_entries)
+		return NULL;
+
+	char path_normalized[CACHE_KEY_LENGTH_MAX];
+	itu_lib_fileutils_normalize_path(path, path_normalized, CACHE_KEY_LENGTH_MAX);
+	int entry_loc = stbds_shgeti(ctx_rstorage.pack_entries, path_normalized);
+	if(entry_loc == -1)
+		return NULL;
+
+	const ITU_AssetPackEntry* entry = ctx_rstorage.pack_entries[entry_loc].value;
+	if(entry->type != (Uint32)type)
+		return NULL;
+
+	// the packer only writes RGBA32 and the 16 bit formats chosen by `itu_lib_assetpack_image_compact_format`
+	if(
+		type == ITU_ASSETPACK_ENTRY_TYPE_IMAGE &&
+		entry->format != SDL_PIXELFORMAT_RGBA32 && entry->format != SDL_PIXELFORMAT_RGB565 &&
+		entry->format != SDL_PIXELFORMAT_RGBA5551 && entry->format != SDL_PIXELFORMAT_RGBA4444
+	)
+		return NULL;
+
+	return entry;
+}
+
+// converts tightly packed pixels to `format_dst`. Returns `pixels` itself if already in `format_dst`, otherwise a new buffer
+// to free with `SDL_free` (NULL on failure)
+static const void* itu_sys_rstorage_pixels_convert(const void* pixels, SDL_PixelFormat format_src, SDL_PixelFormat format_dst, int w, int h)
+{
+	if(format_src == format_dst)
+		return pixels;
+
+	int pitch_dst = w * SDL_BYTESPERPIXEL(format_dst);
+	void* ret = SDL_malloc((size_t)pitch_dst * h);
+	if(!SDL_ConvertPixels(w, h, format_src, pixels, w * SDL_BYTESPERPIXEL(format_src), format_dst, ret, pitch_dst))
+	{
+		SDL_free(ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+// =====================================================================================
+// hot reload
+// =====================================================================================
+// in ENABLE_DIAGNOSTICS builds, the source files of all resources loaded from files are watched by a background thread
+// (inotify on Linux, modification time polling elsewhere). Changed images are decoded there, and
+// `itu_sys_rstorage_hotreload_update` swaps them in behind the same ids.
+// NOTE: the cache key of a resource starts with its normalized source path, that's how changed files are matched to resources
+#ifdef ENABLE_DIAGNOSTICS
+static bool itu_sys_rstorage_cache_key_has_path(const char* cache_key, const char* path_normalized)
+{
+	size_t len = SDL_strlen(path_normalized);
+	return SDL_strncmp(cache_key, path_normalized, len) == 0 && cache_key[len] == '|';
+}
+
+static void itu_sys_rstorage_hotreload_decode(const char* path_normalized)
+{
+	HotReloadResult result = { 0 };
+	result.path = SDL_strdup(path_normalized);
+
+	int n;
+	if(stbi_info(path_normalized, &result.w, &result.h, &n))
+		result.pixels = stbi_load(path_normalized, &result.w, &result.h, &n, 4);
+
+	SDL_LockMutex(ctx_rstorage.hotreload_mutex);
+	stbds_arrput(ctx_rstorage.hotreload_results, result);
+	SDL_UnlockMutex(ctx_rstorage.hotreload_mutex);
+}
+
+int itu_sys_rstorage_hotreload_thread_main(void* data)
+{
+	stbds_arr(char*) paths_changed = NULL;
+
+	while(!SDL_GetAtomicInt(&ctx_rstorage.hotreload_quit))
+	{
+#ifdef SDL_PLATFORM_LINUX
+		struct pollfd poll_fd = { ctx_rstorage.hotreload_inotify_fd, POLLIN, 0 };
+		if(poll(&poll_fd, 1, HOTRELOAD_POLL_INTERVAL_MS) > 0)
+		{
+			alignas(struct inotify_event) char buf[4096];
+			ssize_t len = read(ctx_rstorage.hotreload_inotify_fd, buf, sizeof(buf));
+			const struct inotify_event* event;
+			for(char* ptr = buf; ptr < buf + len; ptr += sizeof(struct inotify_event) + event->len)
+			{
+				event = (const struct inotify_event*)ptr;
+				if(event->len == 0)
+					continue;
+
+				SDL_LockMutex(ctx_rstorage.hotreload_mutex);
+				char path[CACHE_KEY_LENGTH_MAX];
+				char path_normalized[CACHE_KEY_LENGTH_MAX];
+				SDL_snprintf(path, CACHE_KEY_LENGTH_MAX, "%s/%s", stbds_hmget(ctx_rstorage.hotreload_inotify_dirs, event->wd), event->name);
+				itu_lib_fileutils_normalize_path(path, path_normalized, CACHE_KEY_LENGTH_MAX);
+				if(stbds_shgeti(ctx_rstorage.hotreload_paths, path_normalized) != -1)
+					stbds_arrput(paths_changed, SDL_strdup(path_normalized));
+				SDL_UnlockMutex(ctx_rstorage.hotreload_mutex);
+			}
+		}
+#else
+		SDL_Delay(HOTRELOAD_POLL_INTERVAL_MS);
+
+		SDL_LockMutex(ctx_rstorage.hotreload_mutex);
+		for(int i = 0; i < stbds_shlen(ctx_rstorage.hotreload_paths); ++i)
+		{
+			SDL_PathInfo path_info;
+			if(SDL_GetPathInfo(ctx_rstorage.hotreload_paths[i].key, &path_info) && path_info.modify_time != ctx_rstorage.hotreload_paths[i].value)
+			{
+				ctx_rstorage.hotreload_paths[i].value = path_info.modify_time;
+				stbds_arrput(paths_changed, SDL_strdup(ctx_rstorage.hotreload_paths[i].key));
+			}
+		}
+		SDL_UnlockMutex(ctx_rstorage.hotreload_mutex);
+#endif
+
+		// NOTE: decoding happens outside the lock, so that loading resources on the render thread is never blocked by it
+		for(int i = 0; i < stbds_arrlen(paths_changed); ++i)
+		{
+			itu_sys_rstorage_hotreload_decode(paths_changed[i]);
+			SDL_free(paths_changed[i]);
+		}
+		stbds_arrsetlen(paths_changed, 0);
+	}
+
+	stbds_arrfree(paths_changed);
+	return 0;
+}
+
+// starts watching the source file of a resource (starting the hot-reload thread if needed)
+static void itu_sys_rstorage_hotreload_watch(const char* path)
+{
+	if(!ctx_rstorage.hotreload_thread)
+	{
+		ctx_rstorage.hotreload_mutex = SDL_CreateMutex();
+		stbds_sh_new_strdup(ctx_rstorage.hotreload_paths);
+		SDL_SetAtomicInt(&ctx_rstorage.hotreload_quit, 0);
+#ifdef SDL_PLATFORM_LINUX
+		ctx_rstorage.hotreload_inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if(ctx_rstorage.hotreload_inotify_fd == -1)
+			SDL_Log("WARNING hot reload disabled, can't initialize inotify");
+#endif
+		ctx_rstorage.hotreload_thread = SDL_CreateThread(itu_sys_rstorage_hotreload_thread_main, "itu_hotreload", NULL);
+		SDL_assert(ctx_rstorage.hotreload_thread);
+	}
+
+	char path_normalized[CACHE_KEY_LENGTH_MAX];
+	itu_lib_fileutils_normalize_path(path, path_normalized, CACHE_KEY_LENGTH_MAX);
+
+	SDL_LockMutex(ctx_rstorage.hotreload_mutex);
+	if(stbds_shgeti(ctx_rstorage.hotreload_paths, path_normalized) == -1)
+	{
+		SDL_PathInfo path_info;
+		SDL_Time modify_time = SDL_GetPathInfo(path_normalized, &path_info) ? path_info.modify_time : 0;
+		stbds_shput(ctx_rstorage.hotreload_paths, path_normalized, modify_time);
+
+#ifdef SDL_PLATFORM_LINUX
+		// NOTE: we watch directories instead of files, because most editors save by replacing the file (that would drop a
+		//       watch on the file itself). Adding the same directory again returns the same descriptor
+		if(ctx_rstorage.hotreload_inotify_fd != -1)
+		{
+			char dir[CACHE_KEY_LENGTH_MAX];
+			SDL_strlcpy(dir, path_normalized, CACHE_KEY_LENGTH_MAX);
+			char* dir_end = SDL_strrchr(dir, '/');
+			if(dir_end)
+				*dir_end = 0;
+			else
+				SDL_strlcpy(dir, ".", CACHE_KEY_LENGTH_MAX);
+
+			int wd = inotify_add_watch(ctx_rstorage.hotreload_inotify_fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO);
+			if(wd != -1 && stbds_hmgeti(ctx_rstorage.hotreload_inotify_dirs, wd) == -1)
+				stbds_hmput(ctx_rstorage.hotreload_inotify_dirs, wd, SDL_strdup(dir));
+		}
+#endif
+	}
+	SDL_UnlockMutex(ctx_rstorage.hotreload_mutex);
+}
+
+static void itu_sys_rstorage_hotreload_texture(SDLContext* context, TextureData* data, HotReloadResult* result)
+{
+	if(!result->pixels)
+	{
+		SDL_Log("hot reload: invalid or not supported texture file '%s'", result->path);
+		return;
+	}
+
+	// same size: new content in the same texture (and same region, if packed), so even raw `SDL_Texture*` users see it
+	// NOTE: the format stays the same, even if the new content doesn't fit it exactly anymore
+	if(result->w == (int)data->rect.w && result->h == (int)data->rect.h)
+	{
+		const void* pixels_upload = itu_sys_rstorage_pixels_convert(result->pixels, SDL_PIXELFORMAT_RGBA32, data->format, result->w, result->h);
+		if(!pixels_upload)
+			return;
+
+		SDL_Rect rect_upload = { (int)data->rect.x, (int)data->rect.y, result->w, result->h };
+		SDL_UpdateTexture(data->texture, &rect_upload, pixels_upload, result->w * SDL_BYTESPERPIXEL(data->format));
+		if(pixels_upload != result->pixels)
+			SDL_free((void*)pixels_upload);
+		return;
+	}
+
+	if(data->atlas_page != -1)
+	{
+		SDL_Log("hot reload: '%s' changed size, packed images can't be resized (restart needed)", result->path);
+		return;
+	}
+
+	SDL_ScaleMode scale_mode;
+	SDL_BlendMode blend_mode;
+	SDL_GetTextureScaleMode(data->texture, &scale_mode);
+	SDL_GetTextureBlendMode(data->texture, &blend_mode);
+
+	SDL_Texture* texture_new = texture_create_from_pixels(context, result->pixels, result->w, result->h, scale_mode);
+	if(!texture_new)
+	{
+		SDL_Log("hot reload: ERROR creating texture for '%s': %s", result->path, SDL_GetError());
+		return;
+	}
+	SDL_SetTextureBlendMode(texture_new, blend_mode);
+
+	// NOTE: the old texture is kept alive until shutdown, because whoever stored its pointer would be left dangling
+	ITU_IdTexture id = stbds_hmget(ctx_rstorage.ptr_to_id_texture, data->texture);
+	stbds_hmdel(ctx_rstorage.ptr_to_id_texture, data->texture);
+	stbds_hmput(ctx_rstorage.ptr_to_id_texture, texture_new, id);
+	stbds_arrput(ctx_rstorage.hotreload_retired_textures, data->texture);
+
+	size_t bytes = (size_t)result->w * (size_t)result->h * 4;
+	ctx_rstorage.cache_bytes = ctx_rstorage.cache_bytes - data->cache.bytes + bytes;
+	data->cache.bytes = bytes;
+	data->texture = texture_new;
+	data->rect = SDL_FRect { 0, 0, (float)result->w, (float)result->h };
+	data->format = SDL_PIXELFORMAT_RGBA32;
+}
+
+static void itu_sys_rstorage_hotreload_font(FontData* data, HotReloadResult* result)
+{
+	// NOTE: reopened from the file, even if the font was loaded from the asset pack
+	TTF_Font* font_new = TTF_OpenFont(result->path, TTF_GetFontSize(data->font));
+	if(!font_new)
+	{
+		SDL_Log("hot reload: invalid or not supported font file '%s'", result->path);
+		return;
+	}
+
+	// NOTE: as for textures, the old font is kept alive until shutdown
+	ITU_IdFont id = stbds_hmget(ctx_rstorage.ptr_to_id_font, data->font);
+	stbds_hmdel(ctx_rstorage.ptr_to_id_font, data->font);
+	stbds_hmput(ctx_rstorage.ptr_to_id_font, font_new, id);
+	stbds_arrput(ctx_rstorage.hotreload_retired_fonts, data->font);
+
+	data->font = font_new;
+}
+#endif // ENABLE_DIAGNOSTICS
+
+// swaps in the resources whose files changed on disk, behind the same ids. To be called once per frame by the render thread.
+// Images with the same size are updated in place (same `SDL_Texture*`), others get a new texture, as fonts do: code that
+// stores pointers instead of ids keeps showing the old version.
+// Does nothing in builds without ENABLE_DIAGNOSTICS
+void itu_sys_rstorage_hotreload_update(SDLContext* context)
+{
+#ifdef ENABLE_DIAGNOSTICS
+	if(!ctx_rstorage.hotreload_thread)
+		return;
+
+	SDL_LockMutex(ctx_rstorage.hotreload_mutex);
+	stbds_arr(HotReloadResult) results = ctx_rstorage.hotreload_results;
+	ctx_rstorage.hotreload_results = NULL;
+	SDL_UnlockMutex(ctx_rstorage.hotreload_mutex);
+
+	for(int i = 0; i < stbds_arrlen(results); ++i)
+	{
+		HotReloadResult* result = &results[i];
+		int reloaded_count = 0;
+
+		// NOTE: the same file can be loaded more than once with different variants (ie, scale modes or font sizes)
+		for(int j = 0; j < stbds_arrlen(ctx_rstorage.storage_texture); ++j)
+		{
+			TextureData* data = &ctx_rstorage.storage_texture[j];
+			if(!data->slot.used || !data->cache.key || !itu_sys_rstorage_cache_key_has_path(data->cache.key, result->path))
+				continue;
+
+			// still streaming the previous version, the next change will be picked up
+			if(itu_sys_rstorage_texture_is_loading(resource_id_make(j, data->slot.generation)))
+				continue;
+
+			itu_sys_rstorage_hotreload_texture(context, data, result);
+			++reloaded_count;
+		}
+		for(int j = 0; j < stbds_arrlen(ctx_rstorage.storage_font); ++j)
+		{
+			FontData* data = &ctx_rstorage.storage_font[j];
+			if(!data->slot.used || !data->cache.key || !itu_sys_rstorage_cache_key_has_path(data->cache.key, result->path))
+				continue;
+
+			itu_sys_rstorage_hotreload_font(data, result);
+			++reloaded_count;
+		}
+
+		if(reloaded_count > 0)
+			SDL_Log("hot reload: '%s' (%d resources)", result->path, reloaded_count);
+
+		stbi_image_free(result->pixels);
+		SDL_free(result->path);
+	}
+	stbds_arrfree(results);
+#endif
+}
+
+// stops watching files, and destroys the old versions of hot-reloaded resources
+void itu_sys_rstorage_hotreload_shutdown()
+{
+#ifdef ENABLE_DIAGNOSTICS
+	if(!ctx_rstorage.hotreload_thread)
+		return;
+
+	SDL_SetAtomicInt(&ctx_rstorage.hotreload_quit, 1);
+	SDL_WaitThread(ctx_rstorage.hotreload_thread, NULL);
+	ctx_rstorage.hotreload_thread = NULL;
+
+#ifdef SDL_PLATFORM_LINUX
+	if(ctx_rstorage.hotreload_inotify_fd != -1)
+		close(ctx_rstorage.hotreload_inotify_fd);
+	for(int i = 0; i < stbds_hmlen(ctx_rstorage.hotreload_inotify_dirs); ++i)
+		SDL_free(ctx_rstorage.hotreload_inotify_dirs[i].value);
+	stbds_hmfree(ctx_rstorage.hotreload_inotify_dirs);
+#endif
+
+	for(int i = 0; i < stbds_arrlen(ctx_rstorage.hotreload_results); ++i)
+	{
+		stbi_image_free(ctx_rstorage.hotreload_results[i].pixels);
+		SDL_free(ctx_rstorage.hotreload_results[i].path);
+	}
+	stbds_arrfree(ctx_rstorage.hotreload_results);
+	stbds_shfree(ctx_rstorage.hotreload_paths);
+
+	for(int i = 0; i < stbds_arrlen(ctx_rstorage.hotreload_retired_textures); ++i)
+		SDL_DestroyTexture(ctx_rstorage.hotreload_retired_textures[i]);
+	stbds_arrfree(ctx_rstorage.hotreload_retired_textures);
+	for(int i = 0; i < stbds_arrlen(ctx_rstorage.hotreload_retired_fonts); ++i)
+		TTF_CloseFont(ctx_rstorage.hotreload_retired_fonts[i]);
+	stbds_arrfree(ctx_rstorage.hotreload_retired_fonts);
+
+	SDL_DestroyMutex(ctx_rstorage.hotreload_mutex);
+	ctx_rstorage.hotreload_mutex = NULL;
+#endif
+}
+
+// =====================================================================================
+// cache
+// =====================================================================================
+static void itu_sys_rstorage_cache_evict();
+
+static void itu_sys_rstorage_cache_key(const char* path, float variant, char* out, int out_len)
+{
+	char path_normalized[CACHE_KEY_LENGTH_MAX];
+	itu_lib_fileutils_normalize_path(path, path_normalized, CACHE_KEY_LENGTH_MAX);
+	SDL_snprintf(out, out_len, "%s|%g", path_normalized, variant);
+}
+
+static void itu_sys_rstorage_cache_info_init(ResourceCacheInfo* cache, const char* key, size_t bytes)
+{
+	cache->key = key ? SDL_strdup(key) : NULL;
+	cache->refcount = 1;
+	cache->bytes = bytes;
+	cache->release_tick = 0;
+	ctx_rstorage.cache_bytes += bytes;
+}
+
+// sets how many bytes of resources can stay loaded after their last release, so that loading them again is free.
+// When the total goes above the budget, unreferenced resources are destroyed, least recently released first.
+// With a budget of 0 (default) resources are destroyed as soon as they are released
+void itu_sys_rstorage_cache_set_budget(size_t bytes)
+{
+	ctx_rstorage.cache_budget = bytes;
+	itu_sys_rstorage_cache_evict();
+}
+
+// estimated memory used by all resources loaded from files, referenced or not
+size_t itu_sys_rstorage_cache_get_bytes()
+{
+	return ctx_rstorage.cache_bytes;
+}
+
+// enables packing of loaded images into shared atlas pages. Only images with both sides <= `max_image_size` are packed,
+// bigger ones (ie, tilesheets) still get their own texture
+// NOTE: only affects textures loaded after this call
+// NOTE: a packed image only has a meaning together with its id (the page pointer is shared), so sprites and tilemaps must be
+//       initialized with `itu_lib_sprite_init_from_resource` and `itu_lib_tilemap_init_from_resource`
+void itu_sys_rstorage_texture_atlas_enable(int page_size, int max_image_size)
+{
+	SDL_assert(max_image_size + ATLAS_PAGE_PADDING <= page_size);
+
+	ctx_rstorage.atlas_page_size = page_size;
+	ctx_rstorage.atlas_max_image_size = max_image_size;
+}
+
+// sets how much quality the image at `path` can lose to save texture memory (see `ITU_TextureQuality`).
+// Packed images only share atlas pages with images of the same format
+// NOTE: only affects loads after this call (an already cached texture is returned as it is)
+void itu_sys_rstorage_texture_set_quality(const char* path, ITU_TextureQuality quality)
+{
+	char path_normalized[CACHE_KEY_LENGTH_MAX];
+	itu_lib_fileutils_normalize_path(path, path_normalized, CACHE_KEY_LENGTH_MAX);
+
+	if(!ctx_rstorage.texture_quality)
+		stbds_sh_new_strdup(ctx_rstorage.texture_quality);
+	stbds_shput(ctx_rstorage.texture_quality, path_normalized, quality);
+}
+
+AtlasPage* itu_sys_rstorage_atlas_page_create(SDLContext* context, SDL_ScaleMode mode, SDL_PixelFormat format)
+{
+	int size = ctx_rstorage.atlas_page_size;
+	int bytes_per_pixel = SDL_BYTESPERPIXEL(format);
+
+	SDL_Texture* texture = SDL_CreateTexture(context->renderer, format, SDL_TEXTUREACCESS_STATIC, size, size);
+	if(!texture)
+	{
+		SDL_Log("ERROR creating atlas page: %s", SDL_GetError());
+		return NULL;
+	}
+	SDL_SetTextureScaleMode(texture, mode);
+	SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+	// static textures content is undefined until uploaded, so clear it to make padding transparent
+	void* pixels_clear = SDL_calloc(size * size, bytes_per_pixel);
+	SDL_UpdateTexture(texture, NULL, pixels_clear, size * bytes_per_pixel);
+	SDL_free(pixels_clear);
+
+	AtlasPage* page = (AtlasPage*)SDL_malloc(sizeof(AtlasPage));
+	page->texture = texture;
+	page->scale_mode = mode;
+	page->format = format;
+	page->packer_nodes = (stbrp_node*)SDL_malloc(size * sizeof(stbrp_node));
+	stbrp_init_target(&page->packer, size, size, page->packer_nodes, size);
+
+	stbds_arrput(ctx_rstorage.atlas_pages, page);
+
+	return page;
+}
+
+// tries to reserve space for a `w`x`h` image in an atlas page (creating a new page if needed), without uploading anything.
+// Returns false if the image can't be packed, in which case it should get its own texture
+bool itu_sys_rstorage_atlas_reserve(SDLContext* context, int w, int h, SDL_ScaleMode mode, SDL_PixelFormat format, TextureData* out_data)
+{
+	if(ctx_rstorage.atlas_page_size == 0 || w > ctx_rstorage.atlas_max_image_size || h > ctx_rstorage.atlas_max_image_size)
+		return false;
+
+	stbrp_rect rect = { 0 };
+	rect.w = w + ATLAS_PAGE_PADDING;
+	rect.h = h + ATLAS_PAGE_PADDING;
+
+	// first fit among existing pages
+	int page_idx = -1;
+	int pages_count = stbds_arrlen(ctx_rstorage.atlas_pages);
+	for(int i = 0; i < pages_count && page_idx == -1; ++i)
+	{
+		AtlasPage* page = ctx_rstorage.atlas_pages[i];
+		if(page->scale_mode != mode || page->format != format)
+			continue;
+
+		stbrp_pack_rects(&page->packer, &rect, 1);
+		if(rect.was_packed)
+			page_idx = i;
+	}
+
+	if(page_idx == -1)
+	{
+		AtlasPage* page = itu_sys_rstorage_atlas_page_create(context, mode, format);
+		if(!page)
+			return false;
+
+		stbrp_pack_rects(&page->packer, &rect, 1);
+		if(!rect.was_packed)
+			return false;
+
+		page_idx = stbds_arrlen(ctx_rstorage.atlas_pages) - 1;
+	}
+
+	AtlasPage* page = ctx_rstorage.atlas_pages[page_idx];
+	out_data->texture = page->texture;
+	out_data->rect = SDL_FRect { (float)rect.x, (float)rect.y, (float)w, (float)h };
+	out_data->atlas_page = page_idx;
+	out_data->format = format;
+
+	return true;
+}
+
+// tries to pack the given image (tightly packed pixels in `format`) in an atlas page (creating a new page if needed).
+// Returns false if the image can't be packed, in which case it should get its own texture
+bool itu_sys_rstorage_atlas_pack(SDLContext* context, const void* pixels, SDL_PixelFormat format, int w, int h, SDL_ScaleMode mode, TextureData* out_data)
+{
+	if(!itu_sys_rstorage_atlas_reserve(context, w, h, mode, format, out_data))
+		return false;
+
+	SDL_Rect rect_upload = { (int)out_data->rect.x, (int)out_data->rect.y, w, h };
+	SDL_UpdateTexture(out_data->texture, &rect_upload, pixels, w * SDL_BYTESPERPIXEL(format));
+
+	return true;
+}
+
+// if the texture is already in the cache, adds a reference to it
+static ITU_IdTexture itu_sys_rstorage_texture_cache_acquire(const char* cache_key)
+{
+	int cache_loc = stbds_shgeti(ctx_rstorage.cache_texture, cache_key);
+	if(cache_loc == -1)
+		return -1;
+
+	ITU_IdTexture id = ctx_rstorage.cache_texture[cache_loc].value;
+	itu_sys_rstorage_texture_data_get(id)->cache.refcount++;
+	return id;
+}
+
+static void itu_sys_rstorage_texture_cache_insert(ITU_IdTexture id, const char* cache_key)
+{
+	TextureData* data = itu_sys_rstorage_texture_data_get(id);
+
+	// atlas pages are never released, so packed images don't count
+	size_t bytes = data->atlas_page == -1 ? (size_t)data->rect.w * (size_t)data->rect.h * SDL_BYTESPERPIXEL(data->format) : 0;
+	itu_sys_rstorage_cache_info_init(&data->cache, cache_key, bytes);
+
+	if(!ctx_rstorage.cache_texture)
+		stbds_sh_new_strdup(ctx_rstorage.cache_texture);
+	stbds_shput(ctx_rstorage.cache_texture, cache_key, id);
+
+	itu_sys_rstorage_cache_evict();
+}
+
+// decodes an image file in RGBA32, or gets its pixels from the asset pack (no decoding, RGBA32 or a 16 bit format).
+// Safe to call from any thread. Pixels must be freed with `stbi_image_free`, unless `out_from_pack` is true
+static unsigned char* itu_sys_rstorage_texture_decode(const char* path, int* out_w, int* out_h, SDL_PixelFormat* out_format, bool* out_from_pack)
+{
+	// images in the asset pack are already decoded, they are uploaded straight from the mapped pages
+	const ITU_AssetPackEntry* pack_entry = itu_sys_rstorage_pack_find(path, ITU_ASSETPACK_ENTRY_TYPE_IMAGE);
+	*out_from_pack = pack_entry != NULL;
+	if(pack_entry)
+	{
+		*out_w = (int)pack_entry->w;
+		*out_h = (int)pack_entry->h;
+		*out_format = (SDL_PixelFormat)pack_entry->format;
+		return (unsigned char*)itu_lib_assetpack_get_entry_data(ctx_rstorage.pack_data, pack_entry);
+	}
+
+	int n;
+	*out_format = SDL_PIXELFORMAT_RGBA32;
+	return stbi_load(path, out_w, out_h, &n, 4);
+}
+
+// picks the texture format for an image, given its quality setting and what the renderer supports natively
+// (a format emulated by the renderer would be converted back to 32 bit on upload, saving nothing)
+static SDL_PixelFormat itu_sys_rstorage_texture_choose_format(SDLContext* context, const char* path, const unsigned char* pixels, SDL_PixelFormat pixels_format, bool from_pack, int w, int h)
+{
+	char path_normalized[CACHE_KEY_LENGTH_MAX];
+	itu_lib_fileutils_normalize_path(path, path_normalized, CACHE_KEY_LENGTH_MAX);
+	int quality_loc = stbds_shgeti(ctx_rstorage.texture_quality, path_normalized);
+	ITU_TextureQuality quality = quality_loc == -1 ? ITU_TEXTURE_QUALITY_FULL : ctx_rstorage.texture_quality[quality_loc].value;
+	if(quality == ITU_TEXTURE_QUALITY_FULL)
+		return SDL_PIXELFORMAT_RGBA32;
+
+	// the packer already stored in a 16 bit format every image that fits one exactly
+	SDL_PixelFormat format_compact = pixels_format;
+	if(pixels_format == SDL_PIXELFORMAT_RGBA32 && (quality == ITU_TEXTURE_QUALITY_COMPACT || !from_pack))
+		format_compact = itu_lib_assetpack_image_compact_format(pixels, w, h, quality == ITU_TEXTURE_QUALITY_COMPACT);
+	if(format_compact == SDL_PIXELFORMAT_RGBA32)
+		return SDL_PIXELFORMAT_RGBA32;
+
+	// same bits per channel, different channel order
+	SDL_PixelFormat candidates[4] = { format_compact, SDL_PIXELFORMAT_UNKNOWN, SDL_PIXELFORMAT_UNKNOWN, SDL_PIXELFORMAT_UNKNOWN };
+	switch(format_compact)
+	{
+		case SDL_PIXELFORMAT_RGB565  : candidates[1] = SDL_PIXELFORMAT_BGR565; break;
+		case SDL_PIXELFORMAT_RGBA5551: candidates[1] = SDL_PIXELFORMAT_ARGB1555; candidates[2] = SDL_PIXELFORMAT_BGRA5551; candidates[3] = SDL_PIXELFORMAT_ABGR1555; break;
+		case SDL_PIXELFORMAT_RGBA4444: candidates[1] = SDL_PIXELFORMAT_ARGB4444; candidates[2] = SDL_PIXELFORMAT_BGRA4444; candidates[3] = SDL_PIXELFORMAT_ABGR4444; break;
+		default: break;
+	}
+
+	const SDL_PixelFormat* formats_supported = (const SDL_PixelFormat*)SDL_GetPointerProperty(
+		SDL_GetRendererProperties(context->renderer), SDL_PROP_RENDERER_TEXTURE_FORMATS_POINTER, NULL
+	);
+	for(int i = 0; i < (int)array_size(candidates) && candidates[i] != SDL_PIXELFORMAT_UNKNOWN; ++i)
+		for(int j = 0; formats_supported && formats_supported[j] != SDL_PIXELFORMAT_UNKNOWN; ++j)
+			if(formats_supported[j] == candidates[i])
+				return candidates[i];
+
+	return SDL_PIXELFORMAT_RGBA32;
+}
+
+// uploads decoded pixels (packed in an atlas page, if enabled, or in their own texture) and adds them to the cache
+static ITU_IdTexture itu_sys_rstorage_texture_register(SDLContext* context, const char* path, SDL_ScaleMode mode, const char* cache_key, unsigned char* pixels, SDL_PixelFormat pixels_format, bool from_pack, int w, int h)
+{
+	SDL_PixelFormat format = itu_sys_rstorage_texture_choose_format(context, path, pixels, pixels_format, from_pack, w, h);
+	const void* pixels_upload = itu_sys_rstorage_pixels_convert(pixels, pixels_format, format, w, h);
+	if(!pixels_upload)
+	{
+		SDL_Log("ERROR converting texture '%s': %s", path, SDL_GetError());
+		return -1;
+	}
+
+	TextureData new_tex_data = { 0 };
+	if(!itu_sys_rstorage_atlas_pack(context, pixels_upload, format, w, h, mode, &new_tex_data))
+	{
+		new_tex_data.texture = texture_create_from_pixels_format(context, pixels_upload, format, w, h, mode);
+		new_tex_data.rect = SDL_FRect { 0, 0, (float)w, (float)h };
+		new_tex_data.atlas_page = -1;
+		new_tex_data.format = format;
+	}
+
+	if(pixels_upload != pixels)
+		SDL_free((void*)pixels_upload);
+
+	if(!new_tex_data.texture)
+	{
+		SDL_Log("ERROR creating texture '%s': %s", path, SDL_GetError());
+		return -1;
+	}
+
+	ITU_IdTexture new_tex_idx = itu_sys_rstorage_texture_slot_alloc(&new_tex_data);
+	itu_sys_rstorage_texture_cache_insert(new_tex_idx, cache_key);
+
+#ifdef ENABLE_DIAGNOSTICS
+	itu_sys_rstorage_texture_set_debug_name(new_tex_idx, path);
+	itu_sys_rstorage_hotreload_watch(path);
+#endif
+
+	return new_tex_idx;
+}
+
+// loads an image file, or returns the id of the already loaded one (with the same scale mode) adding a reference to it.
+// Every load must be matched by an `itu_sys_rstorage_texture_release`
+ITU_IdTexture itu_sys_rstorage_texture_load(SDLContext* context, const char* path, SDL_ScaleMode mode)
+{
+	char cache_key[CACHE_KEY_LENGTH_MAX];
+	itu_sys_rstorage_cache_key(path, (float)mode, cache_key, CACHE_KEY_LENGTH_MAX);
+	ITU_IdTexture new_tex_idx = itu_sys_rstorage_texture_cache_acquire(cache_key);
+	if(new_tex_idx != ITU_RESOURCE_ID_INVALID)
+		return new_tex_idx;
+
+	int w=0, h=0;
+	SDL_PixelFormat pixels_format;
+	bool from_pack;
+	unsigned char* pixels = itu_sys_rstorage_texture_decode(path, &w, &h, &pixels_format, &from_pack);
+	if(!pixels)
+	{
+		SDL_Log("Invalid or not supported texture file '%s'", path);
+		return -1;
+	}
+
+	new_tex_idx = itu_sys_rstorage_texture_register(context, path, mode, cache_key, pixels, pixels_format, from_pack, w, h);
+
+	if(!from_pack)
+		stbi_image_free(pixels);
+
+	return new_tex_idx;
+}
+
+// true if `texture` is an atlas page, shared by many packed images (a rect on it alone doesn't say which one it belongs to)
+bool itu_sys_rstorage_texture_is_atlas_page(SDL_Texture* texture)
+{
+	for(int i = 0; i < stbds_arrlen(ctx_rstorage.atlas_pages); ++i)
+		if(ctx_rstorage.atlas_pages[i]->texture == texture)
+			return true;
+
+	return false;
+}
+
+// NOTE: for atlas pages, returns the id of one of the images packed in it
+ITU_IdTexture itu_sys_rstorage_texture_from_ptr(SDL_Texture* texture)
+{
+	int map_loc = stbds_hmgeti(ctx_rstorage.ptr_to_id_texture, texture);
+	if(map_loc == -1)
+		return -1;
+
+	return ctx_rstorage.ptr_to_id_texture[map_loc].value;
+}
+
+// returns NULL if the id is invalid, or stale (the texture has been released)
+SDL_Texture* itu_sys_rstorage_texture_get_ptr(ITU_IdTexture id)
+{
+	TextureData* data = itu_sys_rstorage_texture_data_get(id);
+	if(!data)
+		return NULL;
+
+	return data->texture;
+}
+
+// returns the region of the texture returned by `itu_sys_rstorage_texture_get_ptr` that contains the given resource
+SDL_FRect itu_sys_rstorage_texture_get_rect(ITU_IdTexture id)
+{
+	TextureData* data = itu_sys_rstorage_texture_data_get(id);
+	if(!data)
+		return SDL_FRect { 0 };
+
+	return data->rect;
+}
+
+// converts a rect expressed in the original image space to the space of the texture returned by `itu_sys_rstorage_texture_get_ptr`
+// (they are the same, unless the image was packed in an atlas page)
+SDL_FRect itu_sys_rstorage_texture_remap_rect(ITU_IdTexture id, SDL_FRect rect)
+{
+	SDL_FRect rect_resource = itu_sys_rstorage_texture_get_rect(id);
+	rect.x += rect_resource.x;
+	rect.y += rect_resource.y;
+	return rect;
+}
+
+ITU_IdTexture itu_sys_rstorage_texture_add(SDL_Texture* texture)
+{
+	TextureData   new_tex_data = { 0 };
+	new_tex_data.texture = texture;
+	new_tex_data.rect = SDL_FRect { 0, 0, (float)texture->w, (float)texture->h };
+	new_tex_data.atlas_page = -1;
+	new_tex_data.format = texture->format;
+	new_tex_data.cache.refcount = 1;
+
+	return itu_sys_rstorage_texture_slot_alloc(&new_tex_data);
+}
+
+void itu_sys_rstorage_texture_set_debug_name(ITU_IdTexture id, const char* debug_name)
+{
+	TextureData* data = itu_sys_rstorage_texture_data_get(id);
+	if(!data)
+		return;
+
+	// NOTE: allocating every single name is BAD, but we haven't looked in allocaiton startegies and memory arenas yet
+	SDL_free(data->debug_name);
+	data->debug_name = SDL_strdup(debug_name);
+}
+
+const char* itu_sys_rstorage_texture_get_debug_name(ITU_IdTexture id)
+{
+	TextureData* data = itu_sys_rstorage_texture_data_get(id);
+	if(!data)
+		return NULL;
+
+	return data->debug_name;
+}
+
+// =====================================================================================
+// texture streaming
+// =====================================================================================
+int itu_sys_rstorage_texture_stream_thread_main(void* data)
+{
+	while(true)
+	{
+		SDL_LockMutex(ctx_rstorage.stream_mutex);
+		while(stbds_arrlen(ctx_rstorage.stream_decode_queue) == 0 && !ctx_rstorage.stream_quit)
+			SDL_WaitCondition(ctx_rstorage.stream_condition, ctx_rstorage.stream_mutex);
+		if(ctx_rstorage.stream_quit)
+		{
+			SDL_UnlockMutex(ctx_rstorage.stream_mutex);
+			break;
+		}
+		TextureStreamRequest* request = ctx_rstorage.stream_decode_queue[0];
+		stbds_arrdel(ctx_rstorage.stream_decode_queue, 0);
+		SDL_UnlockMutex(ctx_rstorage.stream_mutex);
+
+		int w=0, h=0, n=0;
+		request->pixels = stbi_load(request->path, &w, &h, &n, 4);
+		if(!request->pixels || w != request->rect_upload.w || h != request->rect_upload.h)
+		{
+			// file changed (or got corrupted) after we read its header
+			stbi_image_free(request->pixels);
+			request->pixels = NULL;
+			SDL_SetAtomicInt(&request->state, TEXTURE_STREAM_STATE_FAILED);
+		}
+		else
+			SDL_SetAtomicInt(&request->state, TEXTURE_STREAM_STATE_DECODED);
+	}
+
+	return 0;
+}
+
+// returns a texture id that can be used right away: its texture already has the final size, but shows a placeholder color
+// (or nothing, if packed in an atlas page) until the image has been decoded on the loader thread and uploaded by
+// `itu_sys_rstorage_texture_stream_update`. The texture pointer never changes, so it can be stored (ie, in a Sprite)
+// NOTE: only the image header is read on the calling thread
+ITU_IdTexture itu_sys_rstorage_texture_load_async(SDLContext* context, const char* path, SDL_ScaleMode mode)
+{
+	char cache_key[CACHE_KEY_LENGTH_MAX];
+	itu_sys_rstorage_cache_key(path, (float)mode, cache_key, CACHE_KEY_LENGTH_MAX);
+	ITU_IdTexture cached_idx = itu_sys_rstorage_texture_cache_acquire(cache_key);
+	if(cached_idx != ITU_RESOURCE_ID_INVALID)
+		return cached_idx;
+
+	// nothing to decode, uploading right away is cheaper than a placeholder
+	if(itu_sys_rstorage_pack_find(path, ITU_ASSETPACK_ENTRY_TYPE_IMAGE))
+		return itu_sys_rstorage_texture_load(context, path, mode);
+
+	int w=0, h=0, n=0;
+	if(!stbi_info(path, &w, &h, &n))
+	{
+		SDL_Log("Invalid or not supported texture file '%s'", path);
+		return -1;
+	}
+
+	TextureData new_tex_data = { 0 };
+	// NOTE: streamed images are always uploaded in RGBA32 (the content is not known yet when the texture is created)
+	if(!itu_sys_rstorage_atlas_reserve(context, w, h, mode, SDL_PIXELFORMAT_RGBA32, &new_tex_data))
+	{
+		// NOTE: target access, so that the placeholder is a GPU-side clear instead of a full upload
+		new_tex_data.texture = SDL_CreateTexture(context->renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET, w, h);
+		if(!new_tex_data.texture)
+		{
+			SDL_Log("ERROR creating streamed texture '%s': %s", path, SDL_GetError());
+			return -1;
+		}
+		SDL_SetTextureScaleMode(new_tex_data.texture, mode);
+		SDL_SetTextureBlendMode(new_tex_data.texture, SDL_BLENDMODE_BLEND);
+		new_tex_data.rect = SDL_FRect { 0, 0, (float)w, (float)h };
+		new_tex_data.atlas_page = -1;
+		new_tex_data.format = SDL_PIXELFORMAT_RGBA32;
+
+		SDL_Texture* target_prev = SDL_GetRenderTarget(context->renderer);
+		SDL_SetRenderTarget(context->renderer, new_tex_data.texture);
+		SDL_SetRenderDrawColor(context->renderer, TEXTURE_STREAM_PLACEHOLDER_COLOR);
+		SDL_RenderClear(context->renderer);
+		SDL_SetRenderTarget(context->renderer, target_prev);
+	}
+
+	ITU_IdTexture new_tex_idx = itu_sys_rstorage_texture_slot_alloc(&new_tex_data);
+	itu_sys_rstorage_texture_cache_insert(new_tex_idx, cache_key);
+
+#ifdef ENABLE_DIAGNOSTICS
+	itu_sys_rstorage_texture_set_debug_name(new_tex_idx, path);
+	itu_sys_rstorage_hotreload_watch(path);
+#endif
+
+	TextureStreamRequest* request = (TextureStreamRequest*)SDL_calloc(1, sizeof(TextureStreamRequest));
+	request->id = new_tex_idx;
+	request->path = SDL_strdup(path);
+	request->texture = new_tex_data.texture;
+	request->rect_upload = SDL_Rect { (int)new_tex_data.rect.x, (int)new_tex_data.rect.y, w, h };
+	SDL_SetAtomicInt(&request->state, TEXTURE_STREAM_STATE_DECODING);
+	stbds_arrput(ctx_rstorage.stream_requests, request);
+
+	if(!ctx_rstorage.stream_thread)
+	{
+		ctx_rstorage.stream_mutex = SDL_CreateMutex();
+		ctx_rstorage.stream_condition = SDL_CreateCondition();
+		ctx_rstorage.stream_quit = false;
+		ctx_rstorage.stream_thread = SDL_CreateThread(itu_sys_rstorage_texture_stream_thread_main, "itu_texture_stream", NULL);
+		SDL_assert(ctx_rstorage.stream_thread);
+	}
+
+	SDL_LockMutex(ctx_rstorage.stream_mutex);
+	stbds_arrput(ctx_rstorage.stream_decode_queue, request);
+	SDL_SignalCondition(ctx_rstorage.stream_condition);
+	SDL_UnlockMutex(ctx_rstorage.stream_mutex);
+
+	return new_tex_idx;
+}
+
+static void itu_sys_rstorage_texture_stream_request_free(TextureStreamRequest* request)
+{
+	stbi_image_free(request->pixels);
+	SDL_free(request->path);
+	SDL_free(request);
+}
+
+// uploads decoded images, in load order, until `budget_nsecs` is spent (at least one band per call, so it always progresses).
+// To be called once per frame by the render thread
+void itu_sys_rstorage_texture_stream_update(SDLContext* context, SDL_Time budget_nsecs)
+{
+	SDL_Time time_beg = SDL_GetTicksNS();
+
+	int i = 0;
+	while(i < stbds_arrlen(ctx_rstorage.stream_requests))
+	{
+		TextureStreamRequest* request = ctx_rstorage.stream_requests[i];
+		int state = SDL_GetAtomicInt(&request->state);
+		if(state == TEXTURE_STREAM_STATE_DECODING)
+		{
+			++i;
+			continue;
+		}
+
+		// NOTE: if the texture has been released while loading there is nothing to upload, the request is just dropped
+		if(request->texture && state == TEXTURE_STREAM_STATE_DECODED)
+		{
+			int w = request->rect_upload.w;
+			int h = request->rect_upload.h;
+			int band_rows = SDL_max(1, TEXTURE_STREAM_BAND_BYTES / (w * 4));
+			while(request->rows_uploaded < h)
+			{
+				int rows = SDL_min(band_rows, h - request->rows_uploaded);
+				SDL_Rect rect_band = { request->rect_upload.x, request->rect_upload.y + request->rows_uploaded, w, rows };
+				SDL_UpdateTexture(request->texture, &rect_band, request->pixels + (size_t)request->rows_uploaded * w * 4, w * 4);
+				request->rows_uploaded += rows;
+
+				if((SDL_Time)SDL_GetTicksNS() - time_beg >= budget_nsecs)
+					break;
+			}
+
+			// out of budget, continue from here next frame
+			if(request->rows_uploaded < h)
+				return;
+		}
+		else if(request->texture)
+		{
+			// the placeholder stays there, but the id is still valid
+			SDL_Log("Invalid or not supported texture file '%s'", request->path);
+		}
+
+		itu_sys_rstorage_texture_stream_request_free(request);
+		stbds_arrdel(ctx_rstorage.stream_requests, i);
+
+		if((SDL_Time)SDL_GetTicksNS() - time_beg >= budget_nsecs)
+			return;
+	}
+}
+
+bool itu_sys_rstorage_texture_is_loading(ITU_IdTexture id)
+{
+	for(int i = 0; i < stbds_arrlen(ctx_rstorage.stream_requests); ++i)
+		if(ctx_rstorage.stream_requests[i]->id == id)
+			return true;
+
+	return false;
+}
+
+int itu_sys_rstorage_texture_stream_get_pending_count()
+{
+	return stbds_arrlen(ctx_rstorage.stream_requests);
+}
+
+// stops the loader thread, pending textures keep their placeholder
+void itu_sys_rstorage_texture_stream_shutdown()
+{
+	if(!ctx_rstorage.stream_thread)
+		return;
+
+	SDL_LockMutex(ctx_rstorage.stream_mutex);
+	ctx_rstorage.stream_quit = true;
+	SDL_SignalCondition(ctx_rstorage.stream_condition);
+	SDL_UnlockMutex(ctx_rstorage.stream_mutex);
+	SDL_WaitThread(ctx_rstorage.stream_thread, NULL);
+
+	for(int i = 0; i < stbds_arrlen(ctx_rstorage.stream_requests); ++i)
+		itu_sys_rstorage_texture_stream_request_free(ctx_rstorage.stream_requests[i]);
+	stbds_arrfree(ctx_rstorage.stream_requests);
+	stbds_arrfree(ctx_rstorage.stream_decode_queue);
+
+	SDL_DestroyCondition(ctx_rstorage.stream_condition);
+	SDL_DestroyMutex(ctx_rstorage.stream_mutex);
+	ctx_rstorage.stream_thread = NULL;
+	ctx_rstorage.stream_mutex = NULL;
+	ctx_rstorage.stream_condition = NULL;
+}
+
+// =====================================================================================
+// fonts
+// =====================================================================================
+// opens a font file, or returns the id of the already opened one (with the same size) adding a reference to it.
+// Every load must be matched by an `itu_sys_rstorage_font_release`
+ITU_IdFont itu_sys_rstorage_font_load(SDLContext* context, const char* path, float size)
+{
+	char cache_key[CACHE_KEY_LENGTH_MAX];
+	itu_sys_rstorage_cache_key(path, size, cache_key, CACHE_KEY_LENGTH_MAX);
+	int cache_loc = stbds_shgeti(ctx_rstorage.cache_font, cache_key);
+	if(cache_loc != -1)
+	{
+		ITU_IdFont id = ctx_rstorage.cache_font[cache_loc].value;
+		itu_sys_rstorage_font_data_get(id)->cache.refcount++;
+		return id;
+	}
+
+	TTF_Font* new_font;
+	const ITU_AssetPackEntry* pack_entry = itu_sys_rstorage_pack_find(path, ITU_ASSETPACK_ENTRY_TYPE_RAW);
+	if(pack_entry)
+	{
+		const void* font_data = itu_lib_assetpack_get_entry_data(ctx_rstorage.pack_data, pack_entry);
+		new_font = TTF_OpenFontIO(SDL_IOFromConstMem(font_data, (size_t)pack_entry->size), true, size);
+	}
+	else
+		new_font = TTF_OpenFont(path, size);
 
-struct TextureData
+	if(!new_font)
+	{
+		SDL_Log("Invalid or not supported font file '%s'", path);
+		return -1;
+	}
+
+	ITU_IdFont new_font_idx = itu_sys_rstorage_font_add(new_font);
+
+	// NOTE: FreeType keeps the whole file in memory, glyphs rendered by `itu_sys_text` are not counted here
+	SDL_PathInfo path_info;
+	size_t bytes = 0;
+	if(pack_entry)
+		bytes = (size_t)pack_entry->size;
+	else if(SDL_GetPathInfo(path, &path_info))
+		bytes = (size_t)path_info.size;
+	FontData* data = itu_sys_rstorage_font_data_get(new_font_idx);
+	itu_sys_rstorage_cache_info_init(&data->cache, cache_key, bytes);
+
+	if(!ctx_rstorage.cache_font)
+		stbds_sh_new_strdup(ctx_rstorage.cache_font);
+	stbds_shput(ctx_rstorage.cache_font, cache_key, new_font_idx);
+
+	itu_sys_rstorage_cache_evict();
+
+#ifdef ENABLE_DIAGNOSTICS
+	itu_sys_rstorage_font_set_debug_name(new_font_idx, path);
+	itu_sys_rstorage_hotreload_watch(path);
+#endif
+
+	return new_font_idx;
+}
+
+ITU_IdFont itu_sys_rstorage_font_add(TTF_Font* font)
 {
-	SDL_Texture* texture;
-};
-static ITU_IdTexture id_tex_next;
+	FontData new_font_data = { 0 };
+	new_font_data.font= font;
+	new_font_data.cache.refcount = 1;
+
+	return itu_sys_rstorage_font_slot_alloc(&new_font_data);
+}
 
-struct AudioData
+ITU_IdFont itu_sys_rstorage_font_from_ptr(TTF_Font* font)
 {
-	MIX_Audio* audio;
-};
+	int map_loc = stbds_hmgeti(ctx_rstorage.ptr_to_id_font, font);
+	if(map_loc == -1)
+		return -1;
 
-struct FontData
+	return ctx_rstorage.ptr_to_id_font[map_loc].value;
+}
+
+// returns NULL if the id is invalid, or stale (the font has been released)
+TTF_Font* itu_sys_rstorage_font_get_ptr(ITU_IdFont id)
 {
-	TTF_Font* font;
-};
-static ITU_IdTexture id_font_next;
+	FontData* data = itu_sys_rstorage_font_data_get(id);
+	if(!data)
+		return NULL;
 
-struct ITU_ResourceStorageContext
+	return data->font;
+}
+
+void itu_sys_rstorage_font_set_debug_name(ITU_IdFont id, const char* debug_name)
 {
-	stbds_hm(ITU_IdTexture, TextureData) storage_texture;
-	stbds_hm(ITU_IdAudio  , AudioData)   storage_audio;
-	stbds_hm(ITU_IdFont   , FontData)    storage_font;
+	FontData* data = itu_sys_rstorage_font_data_get(id);
+	if(!data)
+		return;
 
-	stbds_hm(ITU_IdTexture, const char*) debug_names_texture;
-	stbds_hm(ITU_IdAudio  , const char*) debug_names_audio;
-	stbds_hm(ITU_IdFont   , const char*) debug_names_font;
-};
-ITU_ResourceStorageContext ctx_rstorage;
+	// NOTE: allocating every single name is BAD, but we haven't looked in allocaiton startegies and memory arenas yet
+	SDL_free(data->debug_name);
+	data->debug_name = SDL_strdup(debug_name);
+}
 
-ITU_IdTexture itu_sys_rstorage_texture_load(SDLContext* context, const char* path, SDL_ScaleMode mode)
+const char* itu_sys_rstorage_font_get_debug_name(ITU_IdFont id)
+{
+	FontData* data = itu_sys_rstorage_font_data_get(id);
+	if(!data)
+		return NULL;
+
+	return data->debug_name;
+}
+
+// =====================================================================================
+// audio
+// =====================================================================================
+// opens (and predecodes, if required by the policy) an audio file, from the asset pack if mounted. Safe to call from any thread
+static MIX_Audio* itu_sys_rstorage_audio_open(MIX_Mixer* mixer, const char* path, ITU_AudioLoadPolicy policy)
 {
-	SDL_Texture*  new_tex = texture_create(context, path, mode);
+	bool predecode = policy == ITU_AUDIO_LOAD_POLICY_PREDECODE;
+	const ITU_AssetPackEntry* pack_entry = itu_sys_rstorage_pack_find(path, ITU_ASSETPACK_ENTRY_TYPE_RAW);
+	if(pack_entry)
+	{
+		const void* audio_data = itu_lib_assetpack_get_entry_data(ctx_rstorage.pack_data, pack_entry);
+		return MIX_LoadAudio_IO(mixer, SDL_IOFromConstMem(audio_data, (size_t)pack_entry->size), predecode, true);
+	}
+
+	return MIX_LoadAudio(mixer, path, predecode);
+}
 
-	if(!new_tex)
+static ITU_IdAudio itu_sys_rstorage_audio_register(MIX_Audio* audio, const char* path, ITU_AudioLoadPolicy policy, const char* cache_key)
+{
+	// predecoded clips are stored as float samples, streamed ones as the original file
+	size_t bytes = 0;
+	const ITU_AssetPackEntry* pack_entry = itu_sys_rstorage_pack_find(path, ITU_ASSETPACK_ENTRY_TYPE_RAW);
+	if(policy == ITU_AUDIO_LOAD_POLICY_PREDECODE)
 	{
-		SDL_Log("Invalid or not supported texture file '%s'", path);
-		return -1;
+		SDL_AudioSpec spec;
+		if(MIX_GetAudioFormat(audio, &spec))
+			bytes = (size_t)SDL_max(MIX_GetAudioDuration(audio), 0) * spec.channels * sizeof(float);
 	}
+	else if(pack_entry)
+		bytes = (size_t)pack_entry->size;
+	else
+	{
+		SDL_PathInfo path_info;
+		if(SDL_GetPathInfo(path, &path_info))
+			bytes = (size_t)path_info.size;
+	}
+
+	AudioClipData new_audio_data = { 0 };
+	new_audio_data.audio = audio;
+	new_audio_data.policy = policy;
+	ITU_IdAudio new_audio_idx = itu_sys_rstorage_audio_slot_alloc(&new_audio_data);
+
+	AudioClipData* data = itu_sys_rstorage_audio_data_get(new_audio_idx);
+	itu_sys_rstorage_cache_info_init(&data->cache, cache_key, bytes);
 
-	ITU_IdTexture new_tex_idx = itu_sys_rstorage_texture_add(new_tex);
+	if(!ctx_rstorage.cache_audio)
+		stbds_sh_new_strdup(ctx_rstorage.cache_audio);
+	stbds_shput(ctx_rstorage.cache_audio, cache_key, new_audio_idx);
 
+	itu_sys_rstorage_cache_evict();
 
 #ifdef ENABLE_DIAGNOSTICS
-	itu_sys_rstorage_texture_set_debug_name(new_tex_idx, path);
+	itu_sys_rstorage_audio_set_debug_name(new_audio_idx, path);
 #endif
 
-	return new_tex_idx;
+	return new_audio_idx;
 }
 
-ITU_IdTexture itu_sys_rstorage_texture_from_ptr(SDL_Texture* texture)
+// loads an audio file, or returns the id of the already loaded one (with the same policy) adding a reference to it.
+// `mixer` is the one the clip will be played on (predecoded clips are converted to its format once, at load).
+// Every load must be matched by an `itu_sys_rstorage_audio_release`
+// NOTE: streamed clips keep the whole compressed file in memory (SDL_mixer reads it at load), only decoding is deferred.
+//       That is still a fraction of the decoded size (ie, about 1/10 for ogg)
+ITU_IdAudio itu_sys_rstorage_audio_load(MIX_Mixer* mixer, const char* path, ITU_AudioLoadPolicy policy)
 {
-	// this is slow, but for the amount of textures we will have at the moment it's more than enough
-	int num_textures = stbds_hmlen(ctx_rstorage.storage_texture);
-	for(int i = 0; i < num_textures; ++i)
-		if(ctx_rstorage.storage_texture[i].value.texture == texture)
-			return ctx_rstorage.storage_texture[i].key;
+	char cache_key[CACHE_KEY_LENGTH_MAX];
+	itu_sys_rstorage_cache_key(path, (float)policy, cache_key, CACHE_KEY_LENGTH_MAX);
+	int cache_loc = stbds_shgeti(ctx_rstorage.cache_audio, cache_key);
+	if(cache_loc != -1)
+	{
+		ITU_IdAudio id = ctx_rstorage.cache_audio[cache_loc].value;
+		itu_sys_rstorage_audio_data_get(id)->cache.refcount++;
+		return id;
+	}
 
-	return -1;
+	MIX_Audio* new_audio = itu_sys_rstorage_audio_open(mixer, path, policy);
+	if(!new_audio)
+	{
+		SDL_Log("Invalid or not supported audio file '%s': %s", path, SDL_GetError());
+		return -1;
+	}
+
+	return itu_sys_rstorage_audio_register(new_audio, path, policy, cache_key);
 }
 
-SDL_Texture* itu_sys_rstorage_texture_get_ptr(ITU_IdTexture id)
+// returns NULL if the id is invalid, or stale (the clip has been released)
+MIX_Audio* itu_sys_rstorage_audio_get_ptr(ITU_IdAudio id)
 {
-	int tex_loc = stbds_hmgeti(ctx_rstorage.storage_texture, id);
-	if(tex_loc == -1)
+	AudioClipData* data = itu_sys_rstorage_audio_data_get(id);
+	if(!data)
 		return NULL;
 
-	return ctx_rstorage.storage_texture[tex_loc].value.texture;
+	return data->audio;
 }
 
-ITU_IdTexture itu_sys_rstorage_texture_add(SDL_Texture* texture)
+void itu_sys_rstorage_audio_set_debug_name(ITU_IdAudio id, const char* debug_name)
 {
-	ITU_IdTexture new_tex_idx = id_tex_next++;
-	TextureData   new_tex_data = { 0 };
-	new_tex_data.texture = texture;
+	AudioClipData* data = itu_sys_rstorage_audio_data_get(id);
+	if(!data)
+		return;
+
+	// NOTE: allocating every single name is BAD, but we haven't looked in allocaiton startegies and memory arenas yet
+	SDL_free(data->debug_name);
+	data->debug_name = SDL_strdup(debug_name);
+}
 
-	stbds_hmput(ctx_rstorage.storage_texture, new_tex_idx, new_tex_data);
+const char* itu_sys_rstorage_audio_get_debug_name(ITU_IdAudio id)
+{
+	AudioClipData* data = itu_sys_rstorage_audio_data_get(id);
+	if(!data)
+		return NULL;
 
-	return new_tex_idx;
+	return data->debug_name;
 }
 
-void itu_sys_rstorage_texture_set_debug_name(ITU_IdTexture id, const char* debug_name)
+// =====================================================================================
+// manifest
+// =====================================================================================
+// all assets are declared up front with `itu_sys_rstorage_manifest_add_*`, then `itu_sys_rstorage_manifest_load` decodes
+// them in parallel on the job system workers (see `itu_sys_jobs`), and `itu_sys_rstorage_manifest_update` registers them
+// (and uploads textures) on the render thread, in declaration order so that ids and atlas packing are deterministic.
+// Every entry adds a reference, as the corresponding `*_load` function would
+//
+// limitations
+// - fonts are opened by the render thread (FreeType objects are not shared across threads), workers don't touch them
+// - entries with the same path and variant are decoded once per entry (only the first one is kept)
+static int itu_sys_rstorage_manifest_add(ITU_AssetType type, const char* path, float variant)
 {
-	// NOTE: allocating every single name is BAD, but we haven't looked in allocaiton startegies and memory arenas yet
-	int len = SDL_strlen(debug_name);
-	char* name_storage = (char*)SDL_malloc(len + 1);
-	SDL_memcpy(name_storage, debug_name, len);
-	name_storage[len] = 0;
+	SDL_assert(!ctx_rstorage.manifest_loading && "entries can't be added while the manifest is loading");
+
+	ManifestEntry entry = { };
+	entry.type = type;
+	entry.path = SDL_strdup(path);
+	entry.variant = variant;
+	entry.id = ITU_RESOURCE_ID_INVALID;
+	stbds_arrput(ctx_rstorage.manifest_entries, entry);
 
-	stbds_hmput(ctx_rstorage.debug_names_texture, id, name_storage);
+	return stbds_arrlen(ctx_rstorage.manifest_entries) - 1;
 }
 
-const char* itu_sys_rstorage_texture_get_debug_name(ITU_IdTexture id)
+// returns the entry index, to get the id once loaded with `itu_sys_rstorage_manifest_get_id`
+int itu_sys_rstorage_manifest_add_texture(const char* path, SDL_ScaleMode mode)
 {
-	int name_loc = stbds_hmgeti(ctx_rstorage.debug_names_texture, id);
-	if(name_loc == -1)
-		return NULL;
+	return itu_sys_rstorage_manifest_add(ITU_ASSET_TYPE_TEXTURE, path, (float)mode);
+}
+
+int itu_sys_rstorage_manifest_add_font(const char* path, float size)
+{
+	return itu_sys_rstorage_manifest_add(ITU_ASSET_TYPE_FONT, path, size);
+}
+
+int itu_sys_rstorage_manifest_add_audio(const char* path, ITU_AudioLoadPolicy policy)
+{
+	return itu_sys_rstorage_manifest_add(ITU_ASSET_TYPE_AUDIO, path, (float)policy);
+}
+
+// NOTE: runs on workers, so it must not touch anything but its own entries (asset pack lookups are read-only)
+static void itu_sys_rstorage_manifest_decode(int item_beg, int item_end, Uint32 worker_index, void* user_data)
+{
+	ManifestEntry* entries = (ManifestEntry*)user_data;
+	for(int i = item_beg; i < item_end; ++i)
+	{
+		ManifestEntry* entry = &entries[i];
+		if(!entry->cached)
+		{
+			switch(entry->type)
+			{
+				case ITU_ASSET_TYPE_TEXTURE: entry->pixels = itu_sys_rstorage_texture_decode(entry->path, &entry->w, &entry->h, &entry->pixels_format, &entry->pixels_from_pack); break;
+				case ITU_ASSET_TYPE_AUDIO:   entry->audio = itu_sys_rstorage_audio_open(ctx_rstorage.manifest_mixer, entry->path, (ITU_AudioLoadPolicy)entry->variant); break;
+				case ITU_ASSET_TYPE_FONT:    /* opened by the render thread */ break;
+			}
+		}
+		SDL_SetAtomicInt(&entry->state, MANIFEST_ENTRY_STATE_DECODED);
+	}
+}
+
+// starts decoding all declared assets on the job system workers (if the job system is not initialized, everything is
+// decoded right here). `mixer` is only needed for audio clips
+void itu_sys_rstorage_manifest_load(MIX_Mixer* mixer)
+{
+	SDL_assert(!ctx_rstorage.manifest_loading);
+
+	int entries_count = stbds_arrlen(ctx_rstorage.manifest_entries);
+	for(int i = ctx_rstorage.manifest_done_count; i < entries_count; ++i)
+	{
+		// already loaded, the render thread will just add a reference
+		ManifestEntry* entry = &ctx_rstorage.manifest_entries[i];
+		char cache_key[CACHE_KEY_LENGTH_MAX];
+		itu_sys_rstorage_cache_key(entry->path, entry->variant, cache_key, CACHE_KEY_LENGTH_MAX);
+		switch(entry->type)
+		{
+			case ITU_ASSET_TYPE_TEXTURE: entry->cached = stbds_shgeti(ctx_rstorage.cache_texture, cache_key) != -1; break;
+			case ITU_ASSET_TYPE_AUDIO:   entry->cached = stbds_shgeti(ctx_rstorage.cache_audio, cache_key) != -1; break;
+			case ITU_ASSET_TYPE_FONT:    entry->cached = stbds_shgeti(ctx_rstorage.cache_font, cache_key) != -1; break;
+		}
+	}
+
+	ctx_rstorage.manifest_mixer = mixer;
+	ctx_rstorage.manifest_loading = true;
+
+	// NOTE: entries of a previously loaded manifest are kept (for `itu_sys_rstorage_manifest_get_id`), only new ones are decoded
+	ManifestEntry* entries_new = ctx_rstorage.manifest_entries + ctx_rstorage.manifest_done_count;
+	ctx_rstorage.manifest_task = itu_sys_jobs_enqueue(itu_sys_rstorage_manifest_decode, entries_count - ctx_rstorage.manifest_done_count, 1, entries_new);
+}
+
+// registers decoded assets (uploading textures) in declaration order, until `budget_nsecs` is spent (at least one per call).
+// Returns true once everything has been loaded. To be called every frame by the render thread, ie while showing a loading screen
+bool itu_sys_rstorage_manifest_update(SDLContext* context, SDL_Time budget_nsecs)
+{
+	if(!ctx_rstorage.manifest_loading)
+		return true;
+
+	SDL_Time time_beg = SDL_GetTicksNS();
+
+	int entries_count = stbds_arrlen(ctx_rstorage.manifest_entries);
+	while(ctx_rstorage.manifest_done_count < entries_count)
+	{
+		ManifestEntry* entry = &ctx_rstorage.manifest_entries[ctx_rstorage.manifest_done_count];
+		if(SDL_GetAtomicInt(&entry->state) != MANIFEST_ENTRY_STATE_DECODED)
+			break;
+
+		char cache_key[CACHE_KEY_LENGTH_MAX];
+		itu_sys_rstorage_cache_key(entry->path, entry->variant, cache_key, CACHE_KEY_LENGTH_MAX);
+		switch(entry->type)
+		{
+			case ITU_ASSET_TYPE_TEXTURE:
+			{
+				entry->id = itu_sys_rstorage_texture_cache_acquire(cache_key);
+				if(entry->id == ITU_RESOURCE_ID_INVALID && entry->pixels)
+					entry->id = itu_sys_rstorage_texture_register(
+						context, entry->path, (SDL_ScaleMode)entry->variant, cache_key,
+						entry->pixels, entry->pixels_format, entry->pixels_from_pack, entry->w, entry->h
+					);
+				else if(entry->id == ITU_RESOURCE_ID_INVALID && entry->cached)
+					entry->id = itu_sys_rstorage_texture_load(context, entry->path, (SDL_ScaleMode)entry->variant); // evicted in the meantime
+				else if(entry->id == ITU_RESOURCE_ID_INVALID)
+					SDL_Log("Invalid or not supported texture file '%s'", entry->path);
+
+				if(entry->pixels && !entry->pixels_from_pack)
+					stbi_image_free(entry->pixels);
+				entry->pixels = NULL;
+			} break;
+			case ITU_ASSET_TYPE_AUDIO:
+			{
+				int cache_loc = stbds_shgeti(ctx_rstorage.cache_audio, cache_key);
+				if(cache_loc != -1)
+				{
+					entry->id = ctx_rstorage.cache_audio[cache_loc].value;
+					itu_sys_rstorage_audio_data_get(entry->id)->cache.refcount++;
+					MIX_DestroyAudio(entry->audio);
+				}
+				else if(entry->audio)
+					entry->id = itu_sys_rstorage_audio_register(entry->audio, entry->path, (ITU_AudioLoadPolicy)entry->variant, cache_key);
+				else if(entry->cached)
+					entry->id = itu_sys_rstorage_audio_load(ctx_rstorage.manifest_mixer, entry->path, (ITU_AudioLoadPolicy)entry->variant); // evicted in the meantime
+				else
+					SDL_Log("Invalid or not supported audio file '%s'", entry->path);
+				entry->audio = NULL;
+			} break;
+			case ITU_ASSET_TYPE_FONT:
+			{
+				entry->id = itu_sys_rstorage_font_load(context, entry->path, entry->variant);
+			} break;
+		}
+
+		SDL_SetAtomicInt(&entry->state, MANIFEST_ENTRY_STATE_DONE);
+		SDL_free(entry->path);
+		entry->path = NULL;
+		ctx_rstorage.manifest_done_count++;
+
+		if((SDL_Time)SDL_GetTicksNS() - time_beg >= budget_nsecs)
+			break;
+	}
+
+	if(ctx_rstorage.manifest_done_count < entries_count)
+		return false;
+
+	// all sub-ranges are done, this only releases the task
+	itu_sys_jobs_wait(ctx_rstorage.manifest_task);
+	ctx_rstorage.manifest_task = NULL;
+	ctx_rstorage.manifest_loading = false;
+
+	return true;
+}
+
+// fraction of the declared assets that have been loaded, in [0, 1]
+float itu_sys_rstorage_manifest_get_progress()
+{
+	int entries_count = stbds_arrlen(ctx_rstorage.manifest_entries);
+	if(entries_count == 0)
+		return 1;
+
+	return (float)ctx_rstorage.manifest_done_count / (float)entries_count;
+}
+
+// id of the loaded asset (ITU_IdTexture, ITU_IdFont or ITU_IdAudio, depending on the entry), -1 if not loaded (yet)
+Uint32 itu_sys_rstorage_manifest_get_id(int entry_idx)
+{
+	SDL_assert(entry_idx >= 0 && entry_idx < stbds_arrlen(ctx_rstorage.manifest_entries));
 
-	return ctx_rstorage.debug_names_texture[name_loc].value;
+	return ctx_rstorage.manifest_entries[entry_idx].id;
 }
 
 // =====================================================================================
-// fonts
+// releasing
 // =====================================================================================
-ITU_IdFont itu_sys_rstorage_font_load(SDLContext* context, const char* path, float size)
+static void itu_sys_rstorage_texture_destroy(ITU_IdTexture id)
 {
-	TTF_Font*  new_font = TTF_OpenFont(path, size);
+	TextureData* data = itu_sys_rstorage_texture_data_get(id);
+	SDL_assert(data && data->cache.refcount == 0);
 
-	if(!new_font)
+	// a streaming request may still point to this texture
+	for(int i = 0; i < stbds_arrlen(ctx_rstorage.stream_requests); ++i)
+		if(ctx_rstorage.stream_requests[i]->id == id)
+			ctx_rstorage.stream_requests[i]->texture = NULL;
+
+	if(data->cache.key)
 	{
-		SDL_Log("Invalid or not supported font file '%s'", path);
-		return -1;
+		// NOTE: the region of packed images is not reused, atlas pages only grow
+		if(data->atlas_page == -1)
+			SDL_DestroyTexture(data->texture);
+		stbds_shdel(ctx_rstorage.cache_texture, data->cache.key);
+		SDL_free(data->cache.key);
+		ctx_rstorage.cache_bytes -= data->cache.bytes;
 	}
 
-	ITU_IdFont new_font_idx = itu_sys_rstorage_font_add(new_font);
+	itu_sys_rstorage_texture_slot_free(id);
+}
 
-#ifdef ENABLE_DIAGNOSTICS
-	itu_sys_rstorage_font_set_debug_name(new_font_idx, path);
-#endif
+static void itu_sys_rstorage_font_destroy(ITU_IdFont id)
+{
+	FontData* data = itu_sys_rstorage_font_data_get(id);
+	SDL_assert(data && data->cache.refcount == 0);
 
-	return new_font_idx;
+	if(data->cache.key)
+	{
+		TTF_CloseFont(data->font);
+		stbds_shdel(ctx_rstorage.cache_font, data->cache.key);
+		SDL_free(data->cache.key);
+		ctx_rstorage.cache_bytes -= data->cache.bytes;
+	}
+
+	itu_sys_rstorage_font_slot_free(id);
 }
 
-ITU_IdFont itu_sys_rstorage_font_add(TTF_Font* font)
+static void itu_sys_rstorage_audio_destroy(ITU_IdAudio id)
 {
-	ITU_IdFont new_font_idx = id_font_next++;
-	FontData new_font_data = { 0 };
-	new_font_data.font= font;
+	AudioClipData* data = itu_sys_rstorage_audio_data_get(id);
+	SDL_assert(data && data->cache.refcount == 0);
 
-	stbds_hmput(ctx_rstorage.storage_font, new_font_idx, new_font_data);
+	if(data->cache.key)
+	{
+		// NOTE: SDL_mixer keeps a reference to audio set on tracks, so this is safe even if it's still playing
+		MIX_DestroyAudio(data->audio);
+		stbds_shdel(ctx_rstorage.cache_audio, data->cache.key);
+		SDL_free(data->cache.key);
+		ctx_rstorage.cache_bytes -= data->cache.bytes;
+	}
 
-	return new_font_idx;
+	itu_sys_rstorage_audio_slot_free(id);
 }
 
-ITU_IdFont itu_sys_rstorage_font_from_ptr(TTF_Font* font)
+// destroys unreferenced resources, least recently released first, until we are back under budget.
+// With no budget, all unreferenced resources are destroyed
+static void itu_sys_rstorage_cache_evict()
 {
-	// this is slow, but for the amount of fonts we will have at the moment it's more than enough
-	int num_fonts = stbds_hmlen(ctx_rstorage.storage_font);
-	for(int i = 0; i < num_fonts; ++i)
-		if(ctx_rstorage.storage_font[i].value.font == font)
-			return ctx_rstorage.storage_font[i].key;
+	while(true)
+	{
+		bool over_budget = ctx_rstorage.cache_bytes > ctx_rstorage.cache_budget;
 
-	return -1;
+		Uint64 oldest_tick = SDL_MAX_UINT64;
+		ITU_IdTexture oldest_texture = ITU_RESOURCE_ID_INVALID;
+		ITU_IdFont    oldest_font = ITU_RESOURCE_ID_INVALID;
+		ITU_IdAudio   oldest_audio = ITU_RESOURCE_ID_INVALID;
+		for(int i = 0; i < stbds_arrlen(ctx_rstorage.storage_texture); ++i)
+		{
+			TextureData* data = &ctx_rstorage.storage_texture[i];
+			if(data->slot.used && data->cache.refcount == 0 && data->cache.release_tick < oldest_tick)
+			{
+				oldest_tick = data->cache.release_tick;
+				oldest_texture = resource_id_make(i, data->slot.generation);
+			}
+		}
+		for(int i = 0; i < stbds_arrlen(ctx_rstorage.storage_font); ++i)
+		{
+			FontData* data = &ctx_rstorage.storage_font[i];
+			if(data->slot.used && data->cache.refcount == 0 && data->cache.release_tick < oldest_tick)
+			{
+				oldest_tick = data->cache.release_tick;
+				oldest_font = resource_id_make(i, data->slot.generation);
+				oldest_texture = ITU_RESOURCE_ID_INVALID;
+			}
+		}
+		for(int i = 0; i < stbds_arrlen(ctx_rstorage.storage_audio); ++i)
+		{
+			AudioClipData* data = &ctx_rstorage.storage_audio[i];
+			if(data->slot.used && data->cache.refcount == 0 && data->cache.release_tick < oldest_tick)
+			{
+				oldest_tick = data->cache.release_tick;
+				oldest_audio = resource_id_make(i, data->slot.generation);
+				oldest_texture = ITU_RESOURCE_ID_INVALID;
+				oldest_font = ITU_RESOURCE_ID_INVALID;
+			}
+		}
+
+		if(oldest_tick == SDL_MAX_UINT64 || (!over_budget && ctx_rstorage.cache_budget > 0))
+			break;
+
+		if(oldest_texture != ITU_RESOURCE_ID_INVALID)
+			itu_sys_rstorage_texture_destroy(oldest_texture);
+		else if(oldest_font != ITU_RESOURCE_ID_INVALID)
+			itu_sys_rstorage_font_destroy(oldest_font);
+		else
+			itu_sys_rstorage_audio_destroy(oldest_audio);
+	}
 }
 
-TTF_Font* itu_sys_rstorage_font_get_ptr(ITU_IdFont id)
+// removes a reference added by `itu_sys_rstorage_texture_load` (or `_load_async`, or `_add`).
+// When there are no references left the id must not be used anymore: the texture is either destroyed or kept in the cache
+// until evicted (see `itu_sys_rstorage_cache_set_budget`).
+// Textures registered with `itu_sys_rstorage_texture_add` are never destroyed
+// NOTE: sprites using the texture must be gone by then
+void itu_sys_rstorage_texture_release(ITU_IdTexture id)
 {
-	int font_loc = stbds_hmgeti(ctx_rstorage.storage_font, id);
-	if(font_loc == -1)
-		return NULL;
+	TextureData* data = itu_sys_rstorage_texture_data_get(id);
+	if(!data || data->cache.refcount == 0)
+	{
+		SDL_Log("WARNING releasing invalid or stale texture %08x", id);
+		return;
+	}
 
-	return ctx_rstorage.storage_font[font_loc].value.font;
+	if(--data->cache.refcount == 0)
+	{
+		data->cache.release_tick = ++ctx_rstorage.cache_tick;
+		itu_sys_rstorage_cache_evict();
+	}
 }
 
-void itu_sys_rstorage_font_set_debug_name(ITU_IdFont id, const char* debug_name)
+// same as `itu_sys_rstorage_texture_release`, for fonts
+// NOTE: glyphs of the font cached by `itu_sys_text` are not released, call `itu_sys_text_clear` when changing level
+void itu_sys_rstorage_font_release(ITU_IdFont id)
 {
-	// NOTE: allocating every single name is BAD, but we haven't looked in allocaiton startegies and memory arenas yet
-	int len = SDL_strlen(debug_name);
-	char* name_storage = (char*)SDL_malloc(len + 1);
-	SDL_memcpy(name_storage, debug_name, len);
-	name_storage[len] = 0;
+	FontData* data = itu_sys_rstorage_font_data_get(id);
+	if(!data || data->cache.refcount == 0)
+	{
+		SDL_Log("WARNING releasing invalid or stale font %08x", id);
+		return;
+	}
 
-	stbds_hmput(ctx_rstorage.debug_names_font, id, name_storage);
+	if(--data->cache.refcount == 0)
+	{
+		data->cache.release_tick = ++ctx_rstorage.cache_tick;
+		itu_sys_rstorage_cache_evict();
+	}
 }
 
-const char* itu_sys_rstorage_font_get_debug_name(ITU_IdFont id)
+// same as `itu_sys_rstorage_texture_release`, for audio clips
+void itu_sys_rstorage_audio_release(ITU_IdAudio id)
 {
-	int name_loc = stbds_hmgeti(ctx_rstorage.debug_names_font, id);
-	if(name_loc == -1)
-		return NULL;
+	AudioClipData* data = itu_sys_rstorage_audio_data_get(id);
+	if(!data || data->cache.refcount == 0)
+	{
+		SDL_Log("WARNING releasing invalid or stale audio clip %08x", id);
+		return;
+	}
 
-	return ctx_rstorage.debug_names_font[name_loc].value;
+	if(--data->cache.refcount == 0)
+	{
+		data->cache.release_tick = ++ctx_rstorage.cache_tick;
+		itu_sys_rstorage_cache_evict();
+	}
 }
+
 // =====================================================================================
 // Debug rendering
 // =====================================================================================
@@ -281,11 +2073,22 @@ inline SDL_ScaleMode sdl_scalemode_from_debug_name_loc(int loc)
 	}
 }
 
+// texture memory saved by a 16 bit format, compared to RGBA32
+static size_t itu_sys_rstorage_debug_texture_bytes_saved(TextureData* texture_data)
+{
+	// textures registered with `*_add` are whatever the caller created
+	if(!texture_data->cache.key)
+		return 0;
+
+	return (size_t)texture_data->rect.w * (size_t)texture_data->rect.h * (4 - SDL_BYTESPERPIXEL(texture_data->format));
+}
+
 void itu_sys_rstorage_debug_render_detail_texture(SDLContext* context, int loc)
 {
-	SDL_Texture* texture = ctx_rstorage.storage_texture[loc].value.texture;
+	TextureData* texture_data = &ctx_rstorage.storage_texture[loc];
+	SDL_Texture* texture = texture_data->texture;
 
-	if(!texture)
+	if(!texture_data->slot.used || !texture)
 	{
 		ImGui::Text("Invalid texture");
 		return;
@@ -300,6 +2103,16 @@ void itu_sys_rstorage_debug_render_detail_texture(SDLContext* context, int loc)
 	SDL_GetTextureScaleMode(texture, &scale_mode);
 
 	ImGui::InputFloat2("size (readonly)", &size.x, "%.0f", ImGuiInputTextFlags_ReadOnly);
+	ImGui::LabelText("references", "%d", texture_data->cache.refcount);
+	ImGui::LabelText("memory", "%.1f KB", texture_data->cache.bytes / 1024.0f);
+	ImGui::LabelText("format", "%s", SDL_GetPixelFormatName(texture_data->format));
+	ImGui::LabelText("memory saved", "%.1f KB", itu_sys_rstorage_debug_texture_bytes_saved(texture_data) / 1024.0f);
+	if(texture_data->atlas_page != -1)
+	{
+		// NOTE: blend and scale mode below are shared by all images in the same page
+		ImGui::Text("atlas page %d", texture_data->atlas_page);
+		ImGui::InputFloat4("atlas rect (readonly)", &texture_data->rect.x, "%.0f", ImGuiInputTextFlags_ReadOnly);
+	}
 
 	int blendmode_loc = sdl_blendmode_to_debug_name_loc(blend_mode);
 	if(ImGui::Combo("blend mode", &blendmode_loc, sdl_enum_names_blendmode, (int)array_size(sdl_enum_names_blendmode), -1))
@@ -323,15 +2136,29 @@ void itu_sys_rstorage_debug_render_detail_texture(SDLContext* context, int loc)
 
 void itu_sys_rstorage_debug_render_detail_audio(SDLContext* context, int loc)
 {
-	// TODO
-	ImGui::Text("TODO NotYetImplemented");
+	AudioClipData* audio_data = &ctx_rstorage.storage_audio[loc];
+
+	if(!audio_data->slot.used || !audio_data->audio)
+	{
+		ImGui::Text("Invalid audio clip");
+		return;
+	}
 
+	Sint64 duration_frames = MIX_GetAudioDuration(audio_data->audio);
+	ImGui::LabelText("policy", audio_data->policy == ITU_AUDIO_LOAD_POLICY_PREDECODE ? "predecoded" : "streamed");
+	if(duration_frames >= 0)
+		ImGui::LabelText("duration", "%.2f s", MIX_AudioFramesToMS(audio_data->audio, duration_frames) / 1000.0f);
+	else
+		ImGui::LabelText("duration", "unknown");
+	ImGui::LabelText("references", "%d", audio_data->cache.refcount);
+	ImGui::LabelText("memory", "%.1f KB", audio_data->cache.bytes / 1024.0f);
 }
 void itu_sys_rstorage_debug_render_detail_font(SDLContext* context, int loc)
 {
-	TTF_Font* font = ctx_rstorage.storage_font[loc].value.font;
+	FontData* font_data = &ctx_rstorage.storage_font[loc];
+	TTF_Font* font = font_data->font;
 
-	if(!font)
+	if(!font_data->slot.used || !font)
 	{
 		ImGui::Text("Invalid font");
 		return;
@@ -380,7 +2207,14 @@ void itu_sys_rstorage_debug_render(SDLContext* context)
 	{
 		if(ImGui::CollapsingHeader("Textures", ImGuiTreeNodeFlags_DefaultOpen))
 		{
-			int textures_count = stbds_hmlen(ctx_rstorage.storage_texture);
+			int textures_count = stbds_arrlen(ctx_rstorage.storage_texture);
+
+			size_t bytes_saved = 0;
+			for(int i = 0; i < textures_count; ++i)
+				if(ctx_rstorage.storage_texture[i].slot.used)
+					bytes_saved += itu_sys_rstorage_debug_texture_bytes_saved(&ctx_rstorage.storage_texture[i]);
+			ImGui::Text("saved by 16 bit formats: %.1f KB", bytes_saved / 1024.0f);
+
 			if(ImGui::BeginTable("debug_rstorage_master_textures", 3, ImGuiTableFlags_SizingFixedFit))
 			{
 
@@ -390,7 +2224,10 @@ void itu_sys_rstorage_debug_render(SDLContext* context)
 				ImGui::TableHeadersRow();
 				for(int i = 0; i < textures_count; ++i)
 				{
-					ITU_IdTexture id = ctx_rstorage.storage_texture[i].key;
+					TextureData* texture_data = &ctx_rstorage.storage_texture[i];
+					if(!texture_data->slot.used)
+						continue;
+					ITU_IdTexture id = resource_id_make(i, texture_data->slot.generation);
 
 					ImGui::TableNextRow();
 
@@ -408,12 +2245,11 @@ void itu_sys_rstorage_debug_render(SDLContext* context)
 					}
 
 					ImGui::TableNextColumn();
-					int pos_debug_name = stbds_hmgeti(ctx_rstorage.debug_names_texture, id);
-					if(pos_debug_name != -1)
-						ImGui::Text("%s", ctx_rstorage.debug_names_texture[pos_debug_name].value);
+					if(texture_data->debug_name)
+						ImGui::Text("%s", texture_data->debug_name);
 
 					ImGui::TableNextColumn();
-					ImGui::Text("%d", id);
+					ImGui::Text("%08x", id);
 				}
 
 				ImGui::EndTable();
@@ -422,8 +2258,46 @@ void itu_sys_rstorage_debug_render(SDLContext* context)
 
 		if(ImGui::CollapsingHeader("Audio clips", ImGuiTreeNodeFlags_DefaultOpen))
 		{
-			// TODO
-			ImGui::Text("TODO NotYetImplemented");
+			int audio_count = stbds_arrlen(ctx_rstorage.storage_audio);
+			if(ImGui::BeginTable("debug_rstorage_master_audio", 3, ImGuiTableFlags_SizingFixedFit))
+			{
+
+				ImGui::TableSetupColumn("");
+				ImGui::TableSetupColumn("name");
+				ImGui::TableSetupColumn("idx");
+				ImGui::TableHeadersRow();
+				for(int i = 0; i < audio_count; ++i)
+				{
+					AudioClipData* audio_data = &ctx_rstorage.storage_audio[i];
+					if(!audio_data->slot.used)
+						continue;
+					ITU_IdAudio id = resource_id_make(i, audio_data->slot.generation);
+
+					ImGui::TableNextRow();
+
+					ImGui::TableNextColumn();
+					char buf_id[48];
+					SDL_snprintf(buf_id, 48, "%3d##debug_rstorage_master_audio", i);
+					if(ImGui::Selectable(
+						buf_id,
+						detail_category == ITU_SYS_RSTORAGE_DETAIL_CATEGORY_AUDIO && i == loc_selected,
+						ImGuiSelectableFlags_SpanAllColumns
+					))
+					{
+						loc_selected = i;
+						detail_category = ITU_SYS_RSTORAGE_DETAIL_CATEGORY_AUDIO;
+					}
+
+					ImGui::TableNextColumn();
+					if(audio_data->debug_name)
+						ImGui::Text("%s", audio_data->debug_name);
+
+					ImGui::TableNextColumn();
+					ImGui::Text("%08x", id);
+				}
+
+				ImGui::EndTable();
+			}
 		}
 
 		if(ImGui::Button("+##add_font"))
@@ -433,7 +2307,7 @@ void itu_sys_rstorage_debug_render(SDLContext* context)
 		ImGui::SameLine();
 		if(ImGui::CollapsingHeader("Fonts", ImGuiTreeNodeFlags_DefaultOpen))
 		{
-			int fonts_count = stbds_hmlen(ctx_rstorage.storage_font);
+			int fonts_count = stbds_arrlen(ctx_rstorage.storage_font);
 			if(ImGui::BeginTable("debug_rstorage_master_fonts", 3, ImGuiTableFlags_SizingFixedFit))
 			{
 
@@ -443,7 +2317,10 @@ void itu_sys_rstorage_debug_render(SDLContext* context)
 				ImGui::TableHeadersRow();
 				for(int i = 0; i < fonts_count; ++i)
 				{
-					ITU_IdFont id = ctx_rstorage.storage_font[i].key;
+					FontData* font_data = &ctx_rstorage.storage_font[i];
+					if(!font_data->slot.used)
+						continue;
+					ITU_IdFont id = resource_id_make(i, font_data->slot.generation);
 
 					ImGui::TableNextRow();
 
@@ -461,12 +2338,11 @@ void itu_sys_rstorage_debug_render(SDLContext* context)
 					}
 
 					ImGui::TableNextColumn();
-					int pos_debug_name = stbds_hmgeti(ctx_rstorage.debug_names_font, id);
-					if(pos_debug_name != -1)
-						ImGui::Text("%s", ctx_rstorage.debug_names_font[pos_debug_name].value);
+					if(font_data->debug_name)
+						ImGui::Text("%s", font_data->debug_name);
 
 					ImGui::TableNextColumn();
-					ImGui::Text("%d", id);
+					ImGui::Text("%08x", id);
 				}
 
 				ImGui::EndTable();
@@ -509,16 +2385,43 @@ bool itu_sys_rstorage_debug_render_font(TTF_Font* font, TTF_Font** new_font)
 	return ret;
 }
 
+// like `itu_sys_rstorage_texture_from_ptr`, but for atlas pages returns the image that contains `rect` (linear scan)
+static ITU_IdTexture itu_sys_rstorage_debug_texture_find(SDL_Texture* texture, const SDL_FRect* rect)
+{
+	if(!rect || !itu_sys_rstorage_texture_is_atlas_page(texture))
+		return itu_sys_rstorage_texture_from_ptr(texture);
+
+	SDL_FPoint point = { rect->x, rect->y };
+	for(int i = 0; i < stbds_arrlen(ctx_rstorage.storage_texture); ++i)
+	{
+		TextureData* data = &ctx_rstorage.storage_texture[i];
+		if(data->slot.used && data->texture == texture && SDL_PointInRectFloat(&point, &data->rect))
+			return resource_id_make(i, data->slot.generation);
+	}
+
+	return -1;
+}
+
+// NOTE: `rect` (if not NULL) is moved along when picking a new texture, so that it keeps pointing to the same region of
+//       the image if either texture is packed in an atlas page
 bool itu_sys_rstorage_debug_render_texture(SDL_Texture* texture, SDL_Texture** new_texture, SDL_FRect* rect)
 {
 	bool ret = false;
 
-	ITU_IdTexture texture_id = itu_sys_rstorage_texture_from_ptr(texture);
+	ITU_IdTexture texture_id = itu_sys_rstorage_debug_texture_find(texture, rect);
 	const char* texture_name = itu_sys_rstorage_texture_get_debug_name(texture_id);
 
+	ITU_IdTexture texture_id_prev = texture_id;
 	if(ImGui::InputInt("texture", (int*)&texture_id))
 	{
 		*new_texture = itu_sys_rstorage_texture_get_ptr(texture_id);
+		if(rect)
+		{
+			SDL_FRect rect_prev = itu_sys_rstorage_texture_get_rect(texture_id_prev);
+			rect->x -= rect_prev.x;
+			rect->y -= rect_prev.y;
+			*rect = itu_sys_rstorage_texture_remap_rect(texture_id, *rect);
+		}
 		ret = true;
 	}
 	ImGui::Text("\t%s", texture_name);
@@ -5,26 +5,89 @@
 #include <itu_engine.hpp>
 #endif
 
+// resource ids are generational handles (slot index + slot generation): ids of released resources
+// become stale and `_get_ptr` returns NULL for them, even after the slot has been reused
 typedef Uint32 ITU_IdTexture;
 typedef Uint32 ITU_IdAudio;
 typedef Uint32 ITU_IdFont;
 
+#define ITU_RESOURCE_ID_INVALID ((Uint32)-1) // returned when a load fails, never a valid id of any type
+
+enum ITU_AssetType
+{
+	ITU_ASSET_TYPE_TEXTURE,
+	ITU_ASSET_TYPE_FONT,
+	ITU_ASSET_TYPE_AUDIO,
+};
+
+// how audio clips are kept in memory
+enum ITU_AudioLoadPolicy
+{
+	ITU_AUDIO_LOAD_POLICY_PREDECODE, // decoded once at load: no decoding while playing, but the biggest footprint (short sound effects)
+	ITU_AUDIO_LOAD_POLICY_STREAM,    // kept compressed, decoded a little ahead while playing (music, long ambience tracks)
+};
+
+// how much quality a texture can lose to save memory. 16 bit formats are RGB565 (opaque images), RGBA5551 (alpha is only
+// 0 or 255, ie, pixel art) or RGBA4444, and are used only if the renderer supports them natively
+enum ITU_TextureQuality
+{
+	ITU_TEXTURE_QUALITY_FULL,     // always RGBA32 (default)
+	ITU_TEXTURE_QUALITY_LOSSLESS, // 16 bit format if it stores the image exactly (ie, pixel art with a small palette)
+	ITU_TEXTURE_QUALITY_COMPACT,  // 16 bit format even if colors get banded (ie, flat UI elements, masks)
+};
+
+bool          itu_sys_rstorage_pack_mount(const char* path);
+void          itu_sys_rstorage_pack_unmount();
+
+void          itu_sys_rstorage_hotreload_update(SDLContext* context);
+void          itu_sys_rstorage_hotreload_shutdown();
+
+int           itu_sys_rstorage_manifest_add_texture(const char* path, SDL_ScaleMode mode);
+int           itu_sys_rstorage_manifest_add_font(const char* path, float size);
+int           itu_sys_rstorage_manifest_add_audio(const char* path, ITU_AudioLoadPolicy policy);
+void          itu_sys_rstorage_manifest_load(MIX_Mixer* mixer);
+bool          itu_sys_rstorage_manifest_update(SDLContext* context, SDL_Time budget_nsecs);
+float         itu_sys_rstorage_manifest_get_progress();
+Uint32        itu_sys_rstorage_manifest_get_id(int entry_idx);
+
+void          itu_sys_rstorage_cache_set_budget(size_t bytes);
+size_t        itu_sys_rstorage_cache_get_bytes();
+
+void          itu_sys_rstorage_texture_atlas_enable(int page_size, int max_image_size);
+void          itu_sys_rstorage_texture_set_quality(const char* path, ITU_TextureQuality quality);
 ITU_IdTexture itu_sys_rstorage_texture_load(SDLContext* context, const char* path, SDL_ScaleMode mode);
+ITU_IdTexture itu_sys_rstorage_texture_load_async(SDLContext* context, const char* path, SDL_ScaleMode mode);
+void          itu_sys_rstorage_texture_stream_update(SDLContext* context, SDL_Time budget_nsecs);
+bool          itu_sys_rstorage_texture_is_loading(ITU_IdTexture id);
+int           itu_sys_rstorage_texture_stream_get_pending_count();
+void          itu_sys_rstorage_texture_stream_shutdown();
 ITU_IdTexture itu_sys_rstorage_texture_add(SDL_Texture* texture);
+void          itu_sys_rstorage_texture_release(ITU_IdTexture id);
 ITU_IdTexture itu_sys_rstorage_texture_from_ptr(SDL_Texture* texture);
+bool          itu_sys_rstorage_texture_is_atlas_page(SDL_Texture* texture);
 SDL_Texture*  itu_sys_rstorage_texture_get_ptr(ITU_IdTexture id);
+SDL_FRect     itu_sys_rstorage_texture_get_rect(ITU_IdTexture id);
+SDL_FRect     itu_sys_rstorage_texture_remap_rect(ITU_IdTexture id, SDL_FRect rect);
 void          itu_sys_rstorage_texture_set_debug_name(ITU_IdTexture id, const char* debug_name);
 const char*   itu_sys_rstorage_texture_get_debug_name(ITU_IdTexture id);
 
 
 ITU_IdFont  itu_sys_rstorage_font_load(SDLContext* context, const char* path, float size);
 ITU_IdFont  itu_sys_rstorage_font_add(TTF_Font* font);
+void        itu_sys_rstorage_font_release(ITU_IdFont id);
 ITU_IdFont  itu_sys_rstorage_font_from_ptr(TTF_Font* font);
 TTF_Font*   itu_sys_rstorage_font_get_ptr(ITU_IdFont id);
 void        itu_sys_rstorage_font_set_debug_name(ITU_IdFont id, const char* debug_name);
 const char* itu_sys_rstorage_font_get_debug_name(ITU_IdFont id);
 
 
+ITU_IdAudio itu_sys_rstorage_audio_load(MIX_Mixer* mixer, const char* path, ITU_AudioLoadPolicy policy);
+void        itu_sys_rstorage_audio_release(ITU_IdAudio id);
+MIX_Audio*  itu_sys_rstorage_audio_get_ptr(ITU_IdAudio id);
+void        itu_sys_rstorage_audio_set_debug_name(ITU_IdAudio id, const char* debug_name);
+const char* itu_sys_rstorage_audio_get_debug_name(ITU_IdAudio id);
+
+
 void itu_sys_rstorage_debug_render(SDLContext* context);
 bool itu_sys_rstorage_debug_render_font(TTF_Font* font, TTF_Font** new_font);
 bool itu_sys_rstorage_debug_render_texture(SDL_Texture* texture, SDL_Texture** new_texture, SDL_FRect* rect);
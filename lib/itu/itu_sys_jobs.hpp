@@ -0,0 +1,259 @@
+// itu_sys_jobs.hpp
+// minimal job system: a pool of worker threads executing parallel-for tasks
+// a task is a function called over sub-ranges of [0, items_count). Every sub-range is executed exactly once, by any worker
+// or by the thread waiting for the task (that helps with its own task instead of sleeping).
+//
+// the task function signature matches box2d `b2TaskCallback`, so the same pool can run physics tasks.
+// `worker_index` is unique among threads running at the same time: 0 is the thread waiting for the task, 1..N are the workers
+//
+// if the system is not initialized (or runs out of task slots) tasks are executed immediately on the calling thread
+//
+// limitations
+// - tasks can't be nested (a task function must not wait for other tasks)
+// - waiting threads spin (then yield) while other threads finish their last sub-ranges, keep tasks short
+
+#ifndef ITU_SYS_JOBS_HPP
+#define ITU_SYS_JOBS_HPP
+
+#ifndef ITU_UNITY_BUILD
+#include <SDL3/SDL.h>
+#include <itu_common.hpp>
+#endif
+
+#define ITU_JOBS_WORKERS_AUTO  -1 // one worker per logical core, minus the calling thread
+#define ITU_JOBS_WORKERS_MAX   32
+#define ITU_JOBS_TASKS_MAX     64
+
+typedef void (*ITU_JobFunction)(int item_beg, int item_end, Uint32 worker_index, void* user_data);
+
+struct ITU_JobTask;
+
+void         itu_sys_jobs_init(int workers_count);
+void         itu_sys_jobs_shutdown();
+int          itu_sys_jobs_get_threads_count();
+ITU_JobTask* itu_sys_jobs_enqueue(ITU_JobFunction fn, int items_count, int min_range, void* user_data);
+void         itu_sys_jobs_wait(ITU_JobTask* task);
+void         itu_sys_jobs_parallel_for(ITU_JobFunction fn, int items_count, int min_range, void* user_data);
+
+#endif // ITU_SYS_JOBS_HPP
+
+#if (defined ITU_SYS_JOBS_IMPLEMENTATION) || (defined ITU_UNITY_BUILD)
+
+struct ITU_JobTask
+{
+	ITU_JobFunction fn;
+	void*           user_data;
+	int             items_count;
+	int             ranges_count;
+
+	SDL_AtomicInt range_next;     // next sub-range to be claimed
+	SDL_AtomicInt ranges_done;
+	SDL_AtomicInt workers_active; // workers that picked up this task and may still touch it
+
+	bool in_use; // protected by `SysJobs::mutex`
+};
+
+struct SysJobs
+{
+	SDL_Thread* threads[ITU_JOBS_WORKERS_MAX];
+	int         workers_count;
+
+	SDL_Mutex*     mutex;
+	SDL_Condition* condition_work;
+	bool           quit;
+
+	ITU_JobTask tasks[ITU_JOBS_TASKS_MAX];
+};
+
+SysJobs sys_jobs_data;
+
+// executes sub-ranges of the given task until there are none left to claim
+void itu_sys_jobs_task_run(ITU_JobTask* task, Uint32 worker_index)
+{
+	while(true)
+	{
+		int range = SDL_AddAtomicInt(&task->range_next, 1);
+		if(range >= task->ranges_count)
+			break;
+
+		// ranges are split evenly, so that every range is at least `min_range` items long
+		int item_beg = (int)((Sint64)task->items_count *  range      / task->ranges_count);
+		int item_end = (int)((Sint64)task->items_count * (range + 1) / task->ranges_count);
+		task->fn(item_beg, item_end, worker_index, task->user_data);
+
+		SDL_AddAtomicInt(&task->ranges_done, 1);
+	}
+}
+
+// NOTE: must be called with `sys_jobs_data.mutex` locked
+ITU_JobTask* itu_sys_jobs_find_pending_task()
+{
+	for(int i = 0; i < ITU_JOBS_TASKS_MAX; ++i)
+	{
+		ITU_JobTask* task = &sys_jobs_data.tasks[i];
+		if(task->in_use && SDL_GetAtomicInt(&task->range_next) < task->ranges_count)
+			return task;
+	}
+	return NULL;
+}
+
+int itu_sys_jobs_worker_main(void* data)
+{
+	Uint32 worker_index = (Uint32)(intptr_t)data;
+
+	SDL_LockMutex(sys_jobs_data.mutex);
+	while(!sys_jobs_data.quit)
+	{
+		ITU_JobTask* task = itu_sys_jobs_find_pending_task();
+		if(!task)
+		{
+			SDL_WaitCondition(sys_jobs_data.condition_work, sys_jobs_data.mutex);
+			continue;
+		}
+
+		SDL_AddAtomicInt(&task->workers_active, 1);
+		SDL_UnlockMutex(sys_jobs_data.mutex);
+
+		itu_sys_jobs_task_run(task, worker_index);
+		SDL_AddAtomicInt(&task->workers_active, -1);
+
+		SDL_LockMutex(sys_jobs_data.mutex);
+	}
+	SDL_UnlockMutex(sys_jobs_data.mutex);
+
+	return 0;
+}
+
+void itu_sys_jobs_init(int workers_count)
+{
+	if(workers_count == ITU_JOBS_WORKERS_AUTO)
+		workers_count = SDL_GetNumLogicalCPUCores() - 1;
+	workers_count = SDL_clamp(workers_count, 0, ITU_JOBS_WORKERS_MAX);
+
+	sys_jobs_data.mutex = SDL_CreateMutex();
+	sys_jobs_data.condition_work = SDL_CreateCondition();
+	sys_jobs_data.quit = false;
+
+	for(int i = 0; i < workers_count; ++i)
+	{
+		char name[32];
+		SDL_snprintf(name, 32, "itu_jobs_worker_%d", i + 1);
+		sys_jobs_data.threads[i] = SDL_CreateThread(itu_sys_jobs_worker_main, name, (void*)(intptr_t)(i + 1));
+		if(!sys_jobs_data.threads[i])
+		{
+			SDL_Log("ERROR creating job worker thread: %s", SDL_GetError());
+			break;
+		}
+		sys_jobs_data.workers_count++;
+	}
+}
+
+void itu_sys_jobs_shutdown()
+{
+	if(!sys_jobs_data.mutex)
+		return;
+
+	SDL_LockMutex(sys_jobs_data.mutex);
+	sys_jobs_data.quit = true;
+	SDL_BroadcastCondition(sys_jobs_data.condition_work);
+	SDL_UnlockMutex(sys_jobs_data.mutex);
+
+	for(int i = 0; i < sys_jobs_data.workers_count; ++i)
+		SDL_WaitThread(sys_jobs_data.threads[i], NULL);
+
+	SDL_DestroyCondition(sys_jobs_data.condition_work);
+	SDL_DestroyMutex(sys_jobs_data.mutex);
+	sys_jobs_data = { 0 };
+}
+
+// number of threads that can run a task at the same time (workers + the waiting thread)
+int itu_sys_jobs_get_threads_count()
+{
+	return sys_jobs_data.workers_count + 1;
+}
+
+// starts executing `fn` over [0, items_count) on the worker threads. `min_range` is the minimum number of items
+// per call (to keep overhead low for small items).
+// Tasks too small to be split still go to a worker, so that callers can overlap them with their own work (ie, box2d
+// solver tasks, that expect to run at the same time as the other ones).
+// Returns NULL if the task has already been executed on the calling thread (no workers, or no free task slots)
+ITU_JobTask* itu_sys_jobs_enqueue(ITU_JobFunction fn, int items_count, int min_range, void* user_data)
+{
+	min_range = SDL_max(min_range, 1);
+
+	// a few ranges per thread, so that threads finishing early can help the slower ones
+	int ranges_count = SDL_clamp(items_count / min_range, 1, itu_sys_jobs_get_threads_count() * 4);
+
+	if(sys_jobs_data.workers_count == 0 || items_count <= 0)
+	{
+		if(items_count > 0)
+			fn(0, items_count, 0, user_data);
+		return NULL;
+	}
+
+	ITU_JobTask* ret = NULL;
+	SDL_LockMutex(sys_jobs_data.mutex);
+	for(int i = 0; i < ITU_JOBS_TASKS_MAX && !ret; ++i)
+		if(!sys_jobs_data.tasks[i].in_use)
+			ret = &sys_jobs_data.tasks[i];
+
+	if(ret)
+	{
+		ret->fn = fn;
+		ret->user_data = user_data;
+		ret->items_count = items_count;
+		ret->ranges_count = ranges_count;
+		SDL_SetAtomicInt(&ret->range_next, 0);
+		SDL_SetAtomicInt(&ret->ranges_done, 0);
+		SDL_SetAtomicInt(&ret->workers_active, 0);
+		ret->in_use = true;
+		SDL_BroadcastCondition(sys_jobs_data.condition_work);
+	}
+	SDL_UnlockMutex(sys_jobs_data.mutex);
+
+	if(!ret)
+	{
+		SDL_Log("WARNING maximum number of job tasks reached, running task on the calling thread");
+		fn(0, items_count, 0, user_data);
+	}
+
+	return ret;
+}
+
+// waits for the given task to be completed, executing its remaining sub-ranges on the calling thread
+void itu_sys_jobs_wait(ITU_JobTask* task)
+{
+	if(!task)
+		return;
+
+	itu_sys_jobs_task_run(task, 0);
+
+	// other threads are finishing their last sub-ranges, spin for a bit then start yielding (in case we have more threads than cores)
+	int spins = 0;
+	while(SDL_GetAtomicInt(&task->ranges_done) < task->ranges_count || SDL_GetAtomicInt(&task->workers_active) > 0)
+	{
+		if(++spins < 1024)
+			SDL_CPUPauseInstruction();
+		else
+			SDL_DelayNS(0);
+	}
+
+	SDL_LockMutex(sys_jobs_data.mutex);
+	task->in_use = false;
+	SDL_UnlockMutex(sys_jobs_data.mutex);
+}
+
+void itu_sys_jobs_parallel_for(ITU_JobFunction fn, int items_count, int min_range, void* user_data)
+{
+	// nothing to split, running it right away is cheaper than waking up a worker
+	if(items_count < 2 * SDL_max(min_range, 1))
+	{
+		if(items_count > 0)
+			fn(0, items_count, 0, user_data);
+		return;
+	}
+
+	itu_sys_jobs_wait(itu_sys_jobs_enqueue(fn, items_count, min_range, user_data));
+}
+
+#endif // (defined ITU_SYS_JOBS_IMPLEMENTATION) || (defined ITU_UNITY_BUILD)
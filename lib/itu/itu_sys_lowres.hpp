@@ -0,0 +1,158 @@
+// itu_sys_lowres.hpp
+// low-resolution rendering for pixel-art games
+// the world is rendered into a fixed-size target texture (ie, 320x180), then blitted once to the window with the biggest
+// integer scale that fits (centered, black bars on the remaining space). Everything rendered after `itu_sys_lowres_end`
+// (ie, ImGui) is drawn at native resolution on top.
+//
+// between `itu_sys_lowres_begin` and `itu_sys_lowres_end` the context behaves as if the window was as big as the target:
+// `window_w`, `window_h` and `mouse_pos` are in target pixels, so camera math and mouse picking keep working unchanged.
+// To map texture pixels 1:1 on target pixels, set the camera `pixels_per_unit` to TEXTURE_PIXELS_PER_UNIT
+//
+// limitations
+// - the upscale uses nearest filtering, so the camera should move in whole target pixels to avoid visible snapping
+
+#ifndef ITU_SYS_LOWRES_HPP
+#define ITU_SYS_LOWRES_HPP
+
+#ifndef ITU_UNITY_BUILD
+#include <SDL3/SDL.h>
+#include <itu_common.hpp>
+#include <itu_lib_engine.hpp>
+#include <itu_sys_renderstats.hpp>
+#endif
+
+bool      itu_sys_lowres_init(SDLContext* context, int w, int h);
+void      itu_sys_lowres_destroy();
+bool      itu_sys_lowres_is_enabled();
+void      itu_sys_lowres_begin(SDLContext* context);
+void      itu_sys_lowres_end(SDLContext* context);
+SDL_FRect itu_sys_lowres_get_window_rect(SDLContext* context);
+
+#endif // ITU_SYS_LOWRES_HPP
+
+#if (defined ITU_SYS_LOWRES_IMPLEMENTATION) || (defined ITU_UNITY_BUILD)
+
+struct SysLowRes
+{
+	SDL_Texture* texture;
+	int w;
+	int h;
+
+	// window state, saved in `begin` and restored in `end`
+	bool         active;
+	SDL_Texture* target_prev;
+	float        window_w;
+	float        window_h;
+	vec2f        mouse_pos;
+};
+
+SysLowRes sys_lowres_data;
+
+bool itu_sys_lowres_init(SDLContext* context, int w, int h)
+{
+	itu_sys_lowres_destroy();
+
+	sys_lowres_data.texture = SDL_CreateTexture(context->renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET, w, h);
+	if(!sys_lowres_data.texture)
+	{
+		SDL_Log("ERROR creating low-res target: %s", SDL_GetError());
+		return false;
+	}
+	SDL_SetTextureScaleMode(sys_lowres_data.texture, SDL_SCALEMODE_NEAREST);
+	SDL_SetTextureBlendMode(sys_lowres_data.texture, SDL_BLENDMODE_NONE);
+
+	sys_lowres_data.w = w;
+	sys_lowres_data.h = h;
+
+	return true;
+}
+
+void itu_sys_lowres_destroy()
+{
+	SDL_assert(!sys_lowres_data.active);
+
+	SDL_DestroyTexture(sys_lowres_data.texture);
+	sys_lowres_data = { 0 };
+}
+
+bool itu_sys_lowres_is_enabled()
+{
+	return sys_lowres_data.texture != NULL;
+}
+
+// where the target lands in the window, in window pixels (integer scale, centered)
+SDL_FRect itu_sys_lowres_get_window_rect(SDLContext* context)
+{
+	int output_w, output_h;
+	SDL_GetCurrentRenderOutputSize(context->renderer, &output_w, &output_h);
+
+	int scale = SDL_max(1, SDL_min(output_w / sys_lowres_data.w, output_h / sys_lowres_data.h));
+
+	SDL_FRect ret;
+	ret.w = (float)(sys_lowres_data.w * scale);
+	ret.h = (float)(sys_lowres_data.h * scale);
+	ret.x = (float)((output_w - (int)ret.w) / 2);
+	ret.y = (float)((output_h - (int)ret.h) / 2);
+
+	return ret;
+}
+
+void itu_sys_lowres_begin(SDLContext* context)
+{
+	if(!sys_lowres_data.texture)
+		return;
+
+	SDL_assert(!sys_lowres_data.active);
+	sys_lowres_data.active = true;
+
+	// mouse position is in window coordinates, the target rect is in output pixels (they differ on high-DPI displays)
+	SDL_FRect rect_window = itu_sys_lowres_get_window_rect(context);
+	float pixel_density = context->window ? SDL_GetWindowPixelDensity(context->window) : 1;
+	sys_lowres_data.mouse_pos = context->mouse_pos;
+	context->mouse_pos.x = (context->mouse_pos.x * pixel_density - rect_window.x) * sys_lowres_data.w / rect_window.w;
+	context->mouse_pos.y = (context->mouse_pos.y * pixel_density - rect_window.y) * sys_lowres_data.h / rect_window.h;
+
+	sys_lowres_data.window_w = context->window_w;
+	sys_lowres_data.window_h = context->window_h;
+	context->window_w = (float)sys_lowres_data.w;
+	context->window_h = (float)sys_lowres_data.h;
+
+	sys_lowres_data.target_prev = SDL_GetRenderTarget(context->renderer);
+	SDL_SetRenderTarget(context->renderer, sys_lowres_data.texture);
+	SDL_SetRenderDrawColor(context->renderer, 0x00, 0x00, 0x00, 0xFF);
+	SDL_RenderClear(context->renderer);
+
+	// NOTE: viewport is per-target state, this sets the active camera viewport on the low-res target
+	if(context->camera_active)
+		camera_set_active(context, context->camera_active);
+}
+
+void itu_sys_lowres_end(SDLContext* context)
+{
+	if(!sys_lowres_data.active)
+		return;
+	sys_lowres_data.active = false;
+
+	context->window_w = sys_lowres_data.window_w;
+	context->window_h = sys_lowres_data.window_h;
+	context->mouse_pos = sys_lowres_data.mouse_pos;
+
+	SDL_SetRenderTarget(context->renderer, sys_lowres_data.target_prev);
+
+	// blit on the whole output, ignoring render zoom and camera viewport (restored afterwards)
+	SDL_Rect viewport_prev;
+	float scale_x_prev, scale_y_prev;
+	SDL_GetRenderViewport(context->renderer, &viewport_prev);
+	SDL_GetRenderScale(context->renderer, &scale_x_prev, &scale_y_prev);
+	SDL_SetRenderViewport(context->renderer, NULL);
+	SDL_SetRenderScale(context->renderer, 1, 1);
+
+	SDL_FRect rect_dst = itu_sys_lowres_get_window_rect(context);
+	SDL_RenderTexture(context->renderer, sys_lowres_data.texture, NULL, &rect_dst);
+	itu_sys_renderstats_record(context, sys_lowres_data.texture, SDL_BLENDMODE_NONE, 4, rect_dst.w * rect_dst.h);
+
+	SDL_SetRenderScale(context->renderer, scale_x_prev, scale_y_prev);
+	SDL_SetRenderViewport(context->renderer, &viewport_prev);
+}
+
+#endif // (defined ITU_SYS_LOWRES_IMPLEMENTATION) || (defined ITU_UNITY_BUILD)
@@ -0,0 +1,480 @@
+// itu_sys_particles.hpp
+// lightweight particle system, completely outside the ECS
+// every emitter owns its particles in SoA layout (one array per attribute), so that the per-frame integration can process
+// 4 particles at a time with SIMD instructions (SSE, with a scalar fallback on other architectures).
+// Color and size over lifetime follow the easing curves in `itu_common.hpp`, sampled once into a lookup table
+// when the emitter is created, so the update never calls the easing functions.
+//
+// rendering draws every emitter sharing the same texture and blend mode with a single `SDL_RenderGeometry` call
+//
+// limitations
+// - particles are axis-aligned quads (no rotation)
+// - particles are drawn on top of everything rendered before `itu_sys_particles_render`, there is no sorting with sprites
+// - changing color/size parameters of an existing emitter requires `itu_sys_particles_emitter_refresh`
+
+#ifndef ITU_SYS_PARTICLES_HPP
+#define ITU_SYS_PARTICLES_HPP
+
+#ifndef ITU_UNITY_BUILD
+#include <SDL3/SDL.h>
+#include <SDL3/SDL_intrin.h>
+#include <stb_ds.h>
+#include <itu_common.hpp>
+#include <itu_lib_engine.hpp>
+#include <itu_sys_jobs.hpp>
+#include <itu_sys_renderstats.hpp>
+#endif
+
+#define ITU_PARTICLES_LUT_SIZE          64
+#define ITU_PARTICLES_PER_JOB_MIN       4096
+#define ITU_PARTICLES_SIMD_WIDTH        4
+
+struct ITU_ParticleEmitterDesc
+{
+	SDL_Texture*  texture;
+	SDL_FRect     rect;       // region of the texture used by every particle
+	SDL_BlendMode blend_mode;
+
+	int   particles_max;
+	float spawn_rate;         // particles per second (0 for burst-only emitters)
+
+	float life_min;           // in seconds
+	float life_max;
+	float speed_min;          // in world units per second
+	float speed_max;
+	float direction;          // in radians
+	float direction_spread;   // in radians, particles are emitted in [direction - spread/2, direction + spread/2]
+	float spawn_radius;       // in world units
+
+	vec2f gravity;            // in world units per second^2
+	float drag;               // velocity lost per second (0..1)
+
+	color          color_start;
+	color          color_end;
+	EasingFunction color_easing;
+	float          size_start; // in world units
+	float          size_end;
+	EasingFunction size_easing;
+};
+
+struct ITU_ParticleEmitter
+{
+	ITU_ParticleEmitterDesc desc;
+	vec2f  position;
+	bool   emitting;
+	float  spawn_accumulator;
+	Uint64 random_state;
+
+	int particles_count;
+	int particles_capacity; // rounded up to ITU_PARTICLES_SIMD_WIDTH
+
+	// SoA particle data, 16-bytes aligned
+	float* position_x;
+	float* position_y;
+	float* velocity_x;
+	float* velocity_y;
+	float* age;
+	float* life_inv;
+
+	// color and size over (normalized) lifetime
+	SDL_FColor lut_color[ITU_PARTICLES_LUT_SIZE];
+	float      lut_size[ITU_PARTICLES_LUT_SIZE];
+};
+
+ITU_ParticleEmitterDesc itu_sys_particles_emitter_desc_default(SDL_Texture* texture, SDL_FRect rect);
+ITU_ParticleEmitter*    itu_sys_particles_emitter_create(ITU_ParticleEmitterDesc* desc, vec2f position);
+void itu_sys_particles_emitter_destroy(ITU_ParticleEmitter* emitter);
+void itu_sys_particles_emitter_refresh(ITU_ParticleEmitter* emitter);
+void itu_sys_particles_emitter_burst(ITU_ParticleEmitter* emitter, int count);
+void itu_sys_particles_update(float delta);
+void itu_sys_particles_render(SDLContext* context);
+int  itu_sys_particles_get_live_count();
+void itu_sys_particles_clear();
+
+#endif // ITU_SYS_PARTICLES_HPP
+
+#if (defined ITU_SYS_PARTICLES_IMPLEMENTATION) || (defined ITU_UNITY_BUILD)
+
+struct SysParticles
+{
+	stbds_arr(ITU_ParticleEmitter*) emitters;
+	Uint64 random_seed_next; // every emitter gets its own random sequence, deterministic across runs
+
+	stbds_arr(SDL_Vertex) vertices;
+	stbds_arr(int)        indices;  // same quad pattern for every batch, grown on demand
+};
+
+SysParticles sys_particles_data;
+
+// NOTE: `rect` is used as it is, for textures packed in an atlas page remap it first (see `itu_sys_rstorage_texture_remap_rect`)
+ITU_ParticleEmitterDesc itu_sys_particles_emitter_desc_default(SDL_Texture* texture, SDL_FRect rect)
+{
+	ITU_ParticleEmitterDesc desc = { 0 };
+	desc.texture = texture;
+	desc.rect = rect;
+	desc.blend_mode = SDL_BLENDMODE_BLEND;
+	desc.particles_max = 1024;
+	desc.spawn_rate = 64;
+	desc.life_min = 0.5f;
+	desc.life_max = 1.0f;
+	desc.speed_min = 1;
+	desc.speed_max = 2;
+	desc.direction = PI / 2;
+	desc.direction_spread = PI / 4;
+	desc.color_start = COLOR_WHITE;
+	desc.color_end = COLOR_TRANSPARENT_WHITE;
+	desc.color_easing = EASING_LINEAR;
+	desc.size_start = 0.25f;
+	desc.size_end = 0.0f;
+	desc.size_easing = EASING_LINEAR;
+
+	return desc;
+}
+
+// samples color and size curves in the emitter lookup tables
+void itu_sys_particles_emitter_refresh(ITU_ParticleEmitter* emitter)
+{
+	ITU_ParticleEmitterDesc* desc = &emitter->desc;
+	for(int i = 0; i < ITU_PARTICLES_LUT_SIZE; ++i)
+	{
+		float t = (float)i / (ITU_PARTICLES_LUT_SIZE - 1);
+
+		float t_color = easing(t, desc->color_easing);
+		emitter->lut_color[i].r = lerp(desc->color_start.r, desc->color_end.r, t_color);
+		emitter->lut_color[i].g = lerp(desc->color_start.g, desc->color_end.g, t_color);
+		emitter->lut_color[i].b = lerp(desc->color_start.b, desc->color_end.b, t_color);
+		emitter->lut_color[i].a = lerp(desc->color_start.a, desc->color_end.a, t_color);
+
+		emitter->lut_size[i] = lerp(desc->size_start, desc->size_end, easing(t, desc->size_easing));
+	}
+}
+
+ITU_ParticleEmitter* itu_sys_particles_emitter_create(ITU_ParticleEmitterDesc* desc, vec2f position)
+{
+	SDL_assert(desc->texture);
+	SDL_assert(desc->particles_max > 0);
+	SDL_assert(desc->life_min > 0 && desc->life_min <= desc->life_max);
+
+	ITU_ParticleEmitter* emitter = (ITU_ParticleEmitter*)SDL_calloc(1, sizeof(ITU_ParticleEmitter));
+	emitter->desc = *desc;
+	emitter->position = position;
+	emitter->emitting = true;
+	emitter->random_state = ++sys_particles_data.random_seed_next;
+
+	emitter->particles_capacity = (desc->particles_max + ITU_PARTICLES_SIMD_WIDTH - 1) / ITU_PARTICLES_SIMD_WIDTH * ITU_PARTICLES_SIMD_WIDTH;
+	size_t array_size = emitter->particles_capacity * sizeof(float);
+
+	// padding lanes are zeroed, so that SIMD kernels can always process full lanes without producing garbage
+	float** arrays[] = { &emitter->position_x, &emitter->position_y, &emitter->velocity_x, &emitter->velocity_y, &emitter->age, &emitter->life_inv };
+	for(int i = 0; i < (int)SDL_arraysize(arrays); ++i)
+	{
+		*arrays[i] = (float*)SDL_aligned_alloc(16, array_size);
+		SDL_memset(*arrays[i], 0, array_size);
+	}
+
+	itu_sys_particles_emitter_refresh(emitter);
+
+	stbds_arrput(sys_particles_data.emitters, emitter);
+	return emitter;
+}
+
+void itu_sys_particles_emitter_destroy(ITU_ParticleEmitter* emitter)
+{
+	for(int i = 0; i < stbds_arrlen(sys_particles_data.emitters); ++i)
+	{
+		if(sys_particles_data.emitters[i] == emitter)
+		{
+			stbds_arrdel(sys_particles_data.emitters, i);
+			break;
+		}
+	}
+
+	SDL_aligned_free(emitter->position_x);
+	SDL_aligned_free(emitter->position_y);
+	SDL_aligned_free(emitter->velocity_x);
+	SDL_aligned_free(emitter->velocity_y);
+	SDL_aligned_free(emitter->age);
+	SDL_aligned_free(emitter->life_inv);
+	SDL_free(emitter);
+}
+
+void itu_sys_particles_clear()
+{
+	while(stbds_arrlen(sys_particles_data.emitters) > 0)
+		itu_sys_particles_emitter_destroy(sys_particles_data.emitters[0]);
+}
+
+// spawns up to `count` particles (less if the emitter is full)
+void itu_sys_particles_emitter_burst(ITU_ParticleEmitter* emitter, int count)
+{
+	ITU_ParticleEmitterDesc* desc = &emitter->desc;
+	Uint64* random_state = &emitter->random_state;
+
+	count = SDL_min(count, desc->particles_max - emitter->particles_count);
+	for(int n = 0; n < count; ++n)
+	{
+		int i = emitter->particles_count++;
+
+		float angle = desc->direction + (SDL_randf_r(random_state) - 0.5f) * desc->direction_spread;
+		float speed = lerp(desc->speed_min, desc->speed_max, SDL_randf_r(random_state));
+		float life  = lerp(desc->life_min, desc->life_max, SDL_randf_r(random_state));
+		float spawn_angle  = SDL_randf_r(random_state) * 2 * PI;
+		float spawn_offset = SDL_randf_r(random_state) * desc->spawn_radius;
+
+		emitter->position_x[i] = emitter->position.x + SDL_cosf(spawn_angle) * spawn_offset;
+		emitter->position_y[i] = emitter->position.y + SDL_sinf(spawn_angle) * spawn_offset;
+		emitter->velocity_x[i] = SDL_cosf(angle) * speed;
+		emitter->velocity_y[i] = SDL_sinf(angle) * speed;
+		emitter->age[i] = 0;
+		emitter->life_inv[i] = 1.0f / life;
+	}
+}
+
+struct ITU_ParticlesIntegrateJob
+{
+	ITU_ParticleEmitter* emitter;
+	float delta;
+	float drag_factor;
+};
+
+// integration kernel, `item_beg` and `item_end` are in SIMD lanes (groups of ITU_PARTICLES_SIMD_WIDTH particles)
+// NOTE: `age` is stored normalized (0..1), so that rendering can index the lookup tables directly
+void itu_sys_particles_integrate_job(int item_beg, int item_end, Uint32 worker_index, void* user_data)
+{
+	ITU_ParticlesIntegrateJob* job = (ITU_ParticlesIntegrateJob*)user_data;
+	ITU_ParticleEmitter* emitter = job->emitter;
+
+	float* pos_x = emitter->position_x;
+	float* pos_y = emitter->position_y;
+	float* vel_x = emitter->velocity_x;
+	float* vel_y = emitter->velocity_y;
+	float* age   = emitter->age;
+	float* life_inv = emitter->life_inv;
+
+	int i_beg = item_beg * ITU_PARTICLES_SIMD_WIDTH;
+	int i_end = item_end * ITU_PARTICLES_SIMD_WIDTH;
+
+#ifdef SDL_SSE_INTRINSICS
+	__m128 delta     = _mm_set1_ps(job->delta);
+	__m128 drag      = _mm_set1_ps(job->drag_factor);
+	__m128 gravity_x = _mm_set1_ps(emitter->desc.gravity.x * job->delta);
+	__m128 gravity_y = _mm_set1_ps(emitter->desc.gravity.y * job->delta);
+	for(int i = i_beg; i < i_end; i += ITU_PARTICLES_SIMD_WIDTH)
+	{
+		__m128 vx = _mm_load_ps(&vel_x[i]);
+		__m128 vy = _mm_load_ps(&vel_y[i]);
+		vx = _mm_mul_ps(_mm_add_ps(vx, gravity_x), drag);
+		vy = _mm_mul_ps(_mm_add_ps(vy, gravity_y), drag);
+		_mm_store_ps(&vel_x[i], vx);
+		_mm_store_ps(&vel_y[i], vy);
+
+		_mm_store_ps(&pos_x[i], _mm_add_ps(_mm_load_ps(&pos_x[i]), _mm_mul_ps(vx, delta)));
+		_mm_store_ps(&pos_y[i], _mm_add_ps(_mm_load_ps(&pos_y[i]), _mm_mul_ps(vy, delta)));
+
+		_mm_store_ps(&age[i], _mm_add_ps(_mm_load_ps(&age[i]), _mm_mul_ps(_mm_load_ps(&life_inv[i]), delta)));
+	}
+#else
+	float delta = job->delta;
+	float drag  = job->drag_factor;
+	float gravity_x = emitter->desc.gravity.x * delta;
+	float gravity_y = emitter->desc.gravity.y * delta;
+	for(int i = i_beg; i < i_end; ++i)
+	{
+		vel_x[i] = (vel_x[i] + gravity_x) * drag;
+		vel_y[i] = (vel_y[i] + gravity_y) * drag;
+		pos_x[i] += vel_x[i] * delta;
+		pos_y[i] += vel_y[i] * delta;
+		age[i] += life_inv[i] * delta;
+	}
+#endif
+}
+
+void itu_sys_particles_update(float delta)
+{
+	for(int e = 0; e < stbds_arrlen(sys_particles_data.emitters); ++e)
+	{
+		ITU_ParticleEmitter* emitter = sys_particles_data.emitters[e];
+
+		// integrate
+		ITU_ParticlesIntegrateJob job;
+		job.emitter = emitter;
+		job.delta = delta;
+		job.drag_factor = SDL_max(0.0f, 1.0f - emitter->desc.drag * delta);
+		int lanes_count = (emitter->particles_count + ITU_PARTICLES_SIMD_WIDTH - 1) / ITU_PARTICLES_SIMD_WIDTH;
+		itu_sys_jobs_parallel_for(itu_sys_particles_integrate_job, lanes_count, ITU_PARTICLES_PER_JOB_MIN / ITU_PARTICLES_SIMD_WIDTH, &job);
+
+		// remove dead particles (swapping in the last one, order doesn't matter)
+		for(int i = 0; i < emitter->particles_count; )
+		{
+			if(emitter->age[i] < 1)
+			{
+				++i;
+				continue;
+			}
+
+			int last = --emitter->particles_count;
+			emitter->position_x[i] = emitter->position_x[last];
+			emitter->position_y[i] = emitter->position_y[last];
+			emitter->velocity_x[i] = emitter->velocity_x[last];
+			emitter->velocity_y[i] = emitter->velocity_y[last];
+			emitter->age[i]        = emitter->age[last];
+			emitter->life_inv[i]   = emitter->life_inv[last];
+		}
+
+		// spawn
+		if(emitter->emitting && emitter->desc.spawn_rate > 0)
+		{
+			emitter->spawn_accumulator += emitter->desc.spawn_rate * delta;
+			int spawn_count = (int)emitter->spawn_accumulator;
+			emitter->spawn_accumulator -= spawn_count;
+			itu_sys_particles_emitter_burst(emitter, spawn_count);
+		}
+	}
+}
+
+struct ITU_ParticlesVerticesJob
+{
+	ITU_ParticleEmitter* emitter;
+	SDL_Vertex* out_vertices;
+	vec2f screen_origin; // world origin in screen space
+	float screen_scale;  // world units to pixels
+	float u_min, v_min, u_max, v_max;
+};
+
+void itu_sys_particles_build_vertices_job(int item_beg, int item_end, Uint32 worker_index, void* user_data)
+{
+	ITU_ParticlesVerticesJob* job = (ITU_ParticlesVerticesJob*)user_data;
+	ITU_ParticleEmitter* emitter = job->emitter;
+
+	for(int i = item_beg; i < item_end; ++i)
+	{
+		int lut_index = (int)(emitter->age[i] * (ITU_PARTICLES_LUT_SIZE - 1));
+		lut_index = SDL_clamp(lut_index, 0, ITU_PARTICLES_LUT_SIZE - 1);
+
+		SDL_FColor tint = emitter->lut_color[lut_index];
+		float half_size = emitter->lut_size[lut_index] * job->screen_scale * 0.5f;
+
+		// world y-axis points up, screen y-axis points down
+		float x = job->screen_origin.x + emitter->position_x[i] * job->screen_scale;
+		float y = job->screen_origin.y - emitter->position_y[i] * job->screen_scale;
+
+		SDL_Vertex* v = &job->out_vertices[i * 4];
+		v[0].position = SDL_FPoint { x - half_size, y - half_size };
+		v[1].position = SDL_FPoint { x + half_size, y - half_size };
+		v[2].position = SDL_FPoint { x + half_size, y + half_size };
+		v[3].position = SDL_FPoint { x - half_size, y + half_size };
+		v[0].tex_coord = SDL_FPoint { job->u_min, job->v_min };
+		v[1].tex_coord = SDL_FPoint { job->u_max, job->v_min };
+		v[2].tex_coord = SDL_FPoint { job->u_max, job->v_max };
+		v[3].tex_coord = SDL_FPoint { job->u_min, job->v_max };
+		v[0].color = tint;
+		v[1].color = tint;
+		v[2].color = tint;
+		v[3].color = tint;
+	}
+}
+
+int itu_sys_particles_emitter_compare(const void* a, const void* b)
+{
+	const ITU_ParticleEmitter* emitter_a = *(const ITU_ParticleEmitter**)a;
+	const ITU_ParticleEmitter* emitter_b = *(const ITU_ParticleEmitter**)b;
+
+	if(emitter_a->desc.blend_mode != emitter_b->desc.blend_mode)
+		return emitter_a->desc.blend_mode < emitter_b->desc.blend_mode ? -1 : 1;
+	if(emitter_a->desc.texture != emitter_b->desc.texture)
+		return emitter_a->desc.texture < emitter_b->desc.texture ? -1 : 1;
+	return 0;
+}
+
+void itu_sys_particles_render(SDLContext* context)
+{
+	ITU_ParticleEmitter** emitters = sys_particles_data.emitters;
+	int emitters_count = stbds_arrlen(emitters);
+
+	// group emitters sharing the same state
+	SDL_qsort(emitters, emitters_count, sizeof(ITU_ParticleEmitter*), itu_sys_particles_emitter_compare);
+
+	// world to screen is a scale + translation (no rotation), so we compute it once instead of per-particle
+	vec2f screen_origin = point_global_to_screen(context, VEC2F_ZERO);
+	float screen_scale  = size_global_to_screen(context, 1);
+
+	int run_beg = 0;
+	while(run_beg < emitters_count)
+	{
+		int run_end = run_beg + 1;
+		int particles_count = emitters[run_beg]->particles_count;
+		while(run_end < emitters_count && itu_sys_particles_emitter_compare(&emitters[run_beg], &emitters[run_end]) == 0)
+			particles_count += emitters[run_end++]->particles_count;
+
+		if(particles_count == 0)
+		{
+			run_beg = run_end;
+			continue;
+		}
+
+		int indices_count_old = stbds_arrlen(sys_particles_data.indices);
+		if(indices_count_old < particles_count * 6)
+		{
+			stbds_arrsetlen(sys_particles_data.indices, particles_count * 6);
+			for(int i = indices_count_old / 6; i < particles_count; ++i)
+			{
+				int* quad_indices = &sys_particles_data.indices[i * 6];
+				quad_indices[0] = i * 4 + 0;
+				quad_indices[1] = i * 4 + 1;
+				quad_indices[2] = i * 4 + 2;
+				quad_indices[3] = i * 4 + 0;
+				quad_indices[4] = i * 4 + 2;
+				quad_indices[5] = i * 4 + 3;
+			}
+		}
+		stbds_arrsetlen(sys_particles_data.vertices, particles_count * 4);
+
+		// every emitter writes its own slice of the shared vertex buffer
+		SDL_Vertex* vertices = sys_particles_data.vertices;
+		for(int e = run_beg; e < run_end; ++e)
+		{
+			ITU_ParticleEmitter* emitter = emitters[e];
+			SDL_Texture* texture = emitter->desc.texture;
+
+			ITU_ParticlesVerticesJob job;
+			job.emitter = emitter;
+			job.out_vertices = vertices;
+			job.screen_origin = screen_origin;
+			job.screen_scale = screen_scale;
+			job.u_min = emitter->desc.rect.x / texture->w;
+			job.v_min = emitter->desc.rect.y / texture->h;
+			job.u_max = (emitter->desc.rect.x + emitter->desc.rect.w) / texture->w;
+			job.v_max = (emitter->desc.rect.y + emitter->desc.rect.h) / texture->h;
+			itu_sys_jobs_parallel_for(itu_sys_particles_build_vertices_job, emitter->particles_count, ITU_PARTICLES_PER_JOB_MIN, &job);
+
+			vertices += emitter->particles_count * 4;
+		}
+
+		SDL_Texture* texture = emitters[run_beg]->desc.texture;
+		SDL_BlendMode blend_mode_prev;
+		SDL_GetTextureBlendMode(texture, &blend_mode_prev);
+		SDL_SetTextureBlendMode(texture, emitters[run_beg]->desc.blend_mode);
+		sdl_set_texture_tint(texture, COLOR_WHITE);
+
+		itu_sys_renderstats_render_geometry(
+			context,
+			texture,
+			sys_particles_data.vertices, particles_count * 4,
+			sys_particles_data.indices, particles_count * 6
+		);
+
+		SDL_SetTextureBlendMode(texture, blend_mode_prev);
+
+		run_beg = run_end;
+	}
+}
+
+int itu_sys_particles_get_live_count()
+{
+	int ret = 0;
+	for(int i = 0; i < stbds_arrlen(sys_particles_data.emitters); ++i)
+		ret += sys_particles_data.emitters[i]->particles_count;
+	return ret;
+}
+
+#endif // (defined ITU_SYS_PARTICLES_IMPLEMENTATION) || (defined ITU_UNITY_BUILD)
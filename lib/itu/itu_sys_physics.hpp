@@ -5,25 +5,37 @@
 #define ITU_SYS_PHYSICS_HPP
 
 #ifndef ITU_UNITY_BUILD
+#include <stb_ds.h>
 #include <itu_lib_engine.hpp>
+#include <itu_sys_jobs.hpp>
 #endif
 
 
 
+// NOTE: synced from box2d move events (see `itu_system_physics`), so sleeping bodies are not read at all and their
+//       entity data is left untouched until they wake up
 struct PhysicsData
 {
 	b2BodyId body_id;
 
+	// body state after the step before the last one, for interpolation
 	vec2f fixed_step_position;
 	float fixed_step_rotation;
 	vec2f fixed_step_velocity;
 	float fixed_step_torque;
 
+	// body state after the last step
+	vec2f step_position;
+	float step_rotation;
+	vec2f step_velocity;
+	float step_torque;
+
 	vec2f velocity;
 	float torque;
 
 	bool ignore_position;
 	bool ignore_rotation;
+	bool sync_pending; // moved during the current frame steps
 };
 
 struct PhysicsStaticData
@@ -36,12 +48,18 @@ struct ShapeData
 	b2ShapeId shape_id;
 };
 
-void itu_sys_physics_init(SDLContext* context);
+void itu_sys_physics_init(SDLContext* context, bool use_jobs);
+void itu_sys_physics_shutdown();
 void itu_sys_physics_reset(const b2WorldDef* world_def);
+void itu_sys_physics_world_def_set_jobs(b2WorldDef* world_def);
 void itu_sys_physics_step(float fixed_delta);
 b2BodyId itu_sys_physics_add_body(void* entity, b2BodyDef* body_def);
 void* itu_sys_physics_get_entity(b2BodyId body_id);
 b2SensorEvents ity_sys_physics_get_sensor_events();
+b2BodyEvents itu_sys_physics_get_body_events();
+void itu_sys_physics_moved_push(void* entity);
+void** itu_sys_physics_moved_get(int* out_count);
+void itu_sys_physics_moved_clear();
 void itu_sys_physics_debug_draw();
 
 
@@ -59,7 +77,8 @@ struct SysPhysics
 {
 	b2WorldId world_id;
 	b2DebugDraw debug_draw;
-	stbds_hm(b2BodyId, void*) map_b2body_entity;
+	bool use_jobs;
+	stbds_arr(void*) entities_moved; // bodies moved since the last sync, filled by `itu_system_physics`
 };
 
 SysPhysics sys_physics_data;
@@ -68,8 +87,12 @@ void fn_box2d_wrapper_draw_polygon(b2Transform transform, const b2Vec2* vertices
 void fn_box2d_wrapper_draw_circle(b2Transform transform, float radius, b2HexColor b2_color, void* context);
 void fn_box2d_wrapper_draw_capsule(b2Vec2 p1, b2Vec2 p2, float radius, b2HexColor b2_color, void* context);
 
-void itu_sys_physics_init(SDLContext* context)
+// with `use_jobs`, worlds created by `itu_sys_physics_reset` run the box2d solver on the job system workers
+// (see `itu_sys_physics_world_def_set_jobs`)
+void itu_sys_physics_init(SDLContext* context, bool use_jobs)
 {
+	sys_physics_data.use_jobs = use_jobs;
+
 	// debug draw
 	sys_physics_data.debug_draw.context = context;
 	sys_physics_data.debug_draw.drawShapes = true;
@@ -78,13 +101,50 @@ void itu_sys_physics_init(SDLContext* context)
 	sys_physics_data.debug_draw.DrawSolidCapsuleFcn = fn_box2d_wrapper_draw_capsule;
 }
 
+// destroys the world (if any) and frees all memory
+void itu_sys_physics_shutdown()
+{
+	if(b2World_IsValid(sys_physics_data.world_id))
+		b2DestroyWorld(sys_physics_data.world_id);
+
+	stbds_arrfree(sys_physics_data.entities_moved);
+	sys_physics_data = { 0 };
+}
+
 void itu_sys_physics_reset(const b2WorldDef* world_def)
 {
 	if(b2World_IsValid(sys_physics_data.world_id))
 		b2DestroyWorld(sys_physics_data.world_id);
+	itu_sys_physics_moved_clear();
+
 
-	stbds_hmfree(sys_physics_data.map_b2body_entity);
-	sys_physics_data.world_id = b2CreateWorld(world_def);
+	b2WorldDef world_def_final = *world_def;
+	if(sys_physics_data.use_jobs)
+		itu_sys_physics_world_def_set_jobs(&world_def_final);
+	sys_physics_data.world_id = b2CreateWorld(&world_def_final);
+}
+
+// box2d task callbacks, backed by the job system (box2d task functions have the same signature as job functions)
+static void* itu_sys_physics_enqueue_task(b2TaskCallback* task, int items_count, int min_range, void* task_context, void* user_context)
+{
+	return itu_sys_jobs_enqueue(task, items_count, min_range, task_context);
+}
+
+static void itu_sys_physics_finish_task(void* user_task, void* user_context)
+{
+	itu_sys_jobs_wait((ITU_JobTask*)user_task);
+}
+
+// sets up `world_def` so that box2d splits its work on all job system threads (also for worlds created without
+// `itu_sys_physics_reset`). The job system must be initialized before creating the world, the workers count is fixed then
+// NOTE: job system thread indices are in [0, threads count), as box2d expects worker indices (ITU_JOBS_WORKERS_MAX is
+//       below box2d B2_MAX_WORKERS)
+void itu_sys_physics_world_def_set_jobs(b2WorldDef* world_def)
+{
+	world_def->workerCount = itu_sys_jobs_get_threads_count();
+	world_def->enqueueTask = itu_sys_physics_enqueue_task;
+	world_def->finishTask = itu_sys_physics_finish_task;
+	world_def->userTaskContext = NULL;
 }
 
 void itu_sys_physics_step(float fixed_delta)
@@ -92,17 +152,17 @@ void itu_sys_physics_step(float fixed_delta)
 	b2World_Step(sys_physics_data.world_id, fixed_delta, 4);
 }
 
+// `entity` is stored as the body user data (overwriting `body_def->userData`), so that box2d events can get back to it
+// without lookups
 b2BodyId itu_sys_physics_add_body(void* entity, b2BodyDef* body_def)
 {
-	b2BodyId ret = b2CreateBody(sys_physics_data.world_id, body_def);
-	stbds_hmput(sys_physics_data.map_b2body_entity, ret, entity);
-
-	return ret;
+	body_def->userData = entity;
+	return b2CreateBody(sys_physics_data.world_id, body_def);
 }
 
 void* itu_sys_physics_get_entity(b2BodyId body_id)
 {
-	return stbds_hmget(sys_physics_data.map_b2body_entity, body_id);
+	return b2Body_GetUserData(body_id);
 }
 
 b2SensorEvents ity_sys_physics_get_sensor_events()
@@ -111,6 +171,30 @@ b2SensorEvents ity_sys_physics_get_sensor_events()
 	return ret;
 }
 
+// only bodies that moved during the last step (ie, awake ones) get a move event
+b2BodyEvents itu_sys_physics_get_body_events()
+{
+	b2BodyEvents ret = b2World_GetBodyEvents(sys_physics_data.world_id);
+	return ret;
+}
+
+// entities whose body moved, so that the sync can touch only those. `entity` must not be pushed twice before a clear
+void itu_sys_physics_moved_push(void* entity)
+{
+	stbds_arrput(sys_physics_data.entities_moved, entity);
+}
+
+void** itu_sys_physics_moved_get(int* out_count)
+{
+	*out_count = stbds_arrlen(sys_physics_data.entities_moved);
+	return sys_physics_data.entities_moved;
+}
+
+void itu_sys_physics_moved_clear()
+{
+	stbds_arrsetlen(sys_physics_data.entities_moved, 0);
+}
+
 void itu_sys_physics_debug_draw()
 {
 	b2World_Draw(sys_physics_data.world_id, &sys_physics_data.debug_draw);
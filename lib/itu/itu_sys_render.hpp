@@ -0,0 +1,400 @@
+// itu_sys_render.hpp
+// batched sprite rendering
+// sprites are queued during the frame, sorted by (layer, blend mode, texture) and every run of sprites sharing the
+// same state is submitted with a single `SDL_RenderGeometry` call. Quad corners, rotation and tint are all computed on the CPU,
+// split across the `itu_sys_jobs` workers (every item writes only its own 4 vertices, so no synchronization is needed)
+//
+// snapshot mode (used when simulation runs on its own thread, see `itu_sys_simthread`)
+// flushing does not draw anything: the sorted sprite list and the active camera are published as a "snapshot" in a triple buffer.
+// The render thread draws the latest complete snapshot with `itu_sys_render_snapshot_render`, interpolating between the previous
+// and the current simulation tick (so what is on screen lags at most one tick behind the simulation).
+// Only sprites pushed with an interpolation key (ie, the entity index) are interpolated, everything else snaps to the latest tick
+//
+// limitations
+// - sprites inside the same layer are NOT drawn in submission order if they use different textures. Use `Sprite::layer`
+//   when the relative order of two sprites matters
+// - tint is baked in the vertex colors, so texture color/alpha mod is reset to white before every submission
+
+#ifndef ITU_SYS_RENDER_HPP
+#define ITU_SYS_RENDER_HPP
+
+#ifndef ITU_UNITY_BUILD
+#include <SDL3/SDL.h>
+#include <stb_ds.h>
+#include <itu_common.hpp>
+#include <itu_lib_engine.hpp>
+#include <itu_lib_sprite.hpp>
+#include <itu_sys_jobs.hpp>
+#include <itu_sys_renderstats.hpp>
+#endif
+
+// minimum number of sprites processed by a single job, smaller batches are not worth the threading overhead
+#define ITU_RENDER_SPRITES_PER_JOB_MIN 256
+
+#define ITU_RENDER_SNAPSHOTS_COUNT        3 // triple buffer: one written by simulation, one ready, one read by rendering
+#define ITU_RENDER_INTERPOLATION_KEY_NONE 0
+
+struct ITU_RenderSpriteItem
+{
+	Sprite        sprite;
+	Transform     transform;
+	SDL_BlendMode blend_mode; // cached from the texture at push time, so we don't query SDL while sorting
+	int           order;      // submission order, used to keep sorting stable
+
+	// snapshot mode only
+	Uint32    interpolation_key;
+	Transform transform_prev; // transform published with the same key in the previous tick
+};
+
+struct ITU_RenderSnapshot
+{
+	stbds_arr(ITU_RenderSpriteItem) sprite_items; // already sorted
+	Camera   camera;
+	Camera   camera_prev;
+	SDL_Time time_published; // SDL_GetTicksNS() when the snapshot was published
+	SDL_Time tick_duration;  // simulation time covered by this snapshot
+	Uint64   tick;           // 0 if nothing has been published in this slot yet
+};
+
+void itu_sys_render_sprite_push(Sprite* sprite, Transform* transform);
+void itu_sys_render_sprite_push_interpolated(Sprite* sprite, Transform* transform, Uint32 interpolation_key);
+void itu_sys_render_sprite_flush(SDLContext* context);
+void itu_sys_render_sprite_build_vertices(SDLContext* context, ITU_RenderSpriteItem* item, SDL_Vertex* out_vertices);
+void itu_sys_render_snapshot_enable(bool enabled);
+bool itu_sys_render_snapshot_is_enabled();
+bool itu_sys_render_snapshot_render(SDLContext* context);
+
+#endif // ITU_SYS_RENDER_HPP
+
+#if (defined ITU_SYS_RENDER_IMPLEMENTATION) || (defined ITU_UNITY_BUILD)
+
+struct SysRender
+{
+	stbds_arr(ITU_RenderSpriteItem) sprite_items;
+	stbds_arr(SDL_Vertex)           sprite_vertices;
+
+	// the index pattern of a quad is always the same, so a single index buffer (grown on demand) is shared by all batches
+	stbds_arr(int) sprite_indices;
+
+	// snapshot mode
+	// `sprite_items` and everything in the "simulation side" block are only touched by the simulation thread,
+	// `sprite_vertices`, `sprite_indices` and `snapshot_read` only by the render thread
+	bool snapshot_mode;
+	ITU_RenderSnapshot snapshots[ITU_RENDER_SNAPSHOTS_COUNT];
+	SDL_AtomicInt      snapshot_ready; // index of the latest complete snapshot, | ITU_RENDER_SNAPSHOT_FLAG_NEW if not read yet
+	int                snapshot_read;
+
+	// simulation side
+	int                  snapshot_write;
+	Uint64               snapshot_tick;
+	Camera               snapshot_camera_prev;
+	stbds_arr(Transform) interpolation_transforms; // indexed by interpolation key
+	stbds_arr(Uint64)    interpolation_ticks;      // tick in which the transform with the same index was published
+};
+
+#define ITU_RENDER_SNAPSHOT_FLAG_NEW 0x100
+
+SysRender sys_render_data;
+
+void itu_sys_render_sprite_push(Sprite* sprite, Transform* transform)
+{
+	itu_sys_render_sprite_push_interpolated(sprite, transform, ITU_RENDER_INTERPOLATION_KEY_NONE);
+}
+
+// same as `itu_sys_render_sprite_push`, `interpolation_key` identifies the same object across ticks in snapshot mode
+// (keep it small, it's used as an array index. ie, entity index + 1)
+void itu_sys_render_sprite_push_interpolated(Sprite* sprite, Transform* transform, Uint32 interpolation_key)
+{
+	// nothing to draw (ie, sprites used only as placeholders)
+	if(!sprite->texture)
+		return;
+
+	ITU_RenderSpriteItem item;
+	item.sprite = *sprite;
+	item.transform = *transform;
+	item.transform_prev = *transform;
+	item.interpolation_key = interpolation_key;
+	item.order = stbds_arrlen(sys_render_data.sprite_items);
+	SDL_GetTextureBlendMode(sprite->texture, &item.blend_mode);
+
+	stbds_arrput(sys_render_data.sprite_items, item);
+}
+
+int itu_sys_render_sprite_item_compare(const void* a, const void* b)
+{
+	const ITU_RenderSpriteItem* item_a = (const ITU_RenderSpriteItem*)a;
+	const ITU_RenderSpriteItem* item_b = (const ITU_RenderSpriteItem*)b;
+
+	if(item_a->sprite.layer != item_b->sprite.layer)
+		return item_a->sprite.layer < item_b->sprite.layer ? -1 : 1;
+	if(item_a->blend_mode != item_b->blend_mode)
+		return item_a->blend_mode < item_b->blend_mode ? -1 : 1;
+	if(item_a->sprite.texture != item_b->sprite.texture)
+		return item_a->sprite.texture < item_b->sprite.texture ? -1 : 1;
+
+	return item_a->order - item_b->order;
+}
+
+// writes the 4 vertices of the given sprite (top-left, top-right, bottom-right, bottom-left), in screen space
+// NOTE: this replicates what `SDL_RenderTextureRotated` does internally, so batched and non-batched sprites look the same
+void itu_sys_render_sprite_build_vertices(SDLContext* context, ITU_RenderSpriteItem* item, SDL_Vertex* out_vertices)
+{
+	Sprite* sprite = &item->sprite;
+
+	SDL_FRect rect_dst = itu_lib_sprite_get_screen_rect(context, sprite, &item->transform);
+	vec2f pivot_dst;
+	pivot_dst.x = rect_dst.x + sprite->pivot.x * rect_dst.w;
+	pivot_dst.y = rect_dst.y + sprite->pivot.y * rect_dst.h;
+
+	// corners relative to the pivot
+	float min_x = -sprite->pivot.x * rect_dst.w;
+	float min_y = -sprite->pivot.y * rect_dst.h;
+	float max_x = min_x + rect_dst.w;
+	float max_y = min_y + rect_dst.h;
+
+	// world rotation is counter-clockwise, screen rotation is clockwise (y axis points down)
+	float s = SDL_sinf(-item->transform.rotation);
+	float c = SDL_cosf(item->transform.rotation);
+
+	float u_min = sprite->rect.x / sprite->texture->w;
+	float v_min = sprite->rect.y / sprite->texture->h;
+	float u_max = (sprite->rect.x + sprite->rect.w) / sprite->texture->w;
+	float v_max = (sprite->rect.y + sprite->rect.h) / sprite->texture->h;
+	if(sprite->flip_horizontal)
+	{
+		float tmp = u_min;
+		u_min = u_max;
+		u_max = tmp;
+	}
+
+	SDL_FColor tint = { sprite->tint.r, sprite->tint.g, sprite->tint.b, sprite->tint.a };
+
+	out_vertices[0].position = SDL_FPoint { c * min_x - s * min_y + pivot_dst.x, s * min_x + c * min_y + pivot_dst.y };
+	out_vertices[1].position = SDL_FPoint { c * max_x - s * min_y + pivot_dst.x, s * max_x + c * min_y + pivot_dst.y };
+	out_vertices[2].position = SDL_FPoint { c * max_x - s * max_y + pivot_dst.x, s * max_x + c * max_y + pivot_dst.y };
+	out_vertices[3].position = SDL_FPoint { c * min_x - s * max_y + pivot_dst.x, s * min_x + c * max_y + pivot_dst.y };
+
+	out_vertices[0].tex_coord = SDL_FPoint { u_min, v_min };
+	out_vertices[1].tex_coord = SDL_FPoint { u_max, v_min };
+	out_vertices[2].tex_coord = SDL_FPoint { u_max, v_max };
+	out_vertices[3].tex_coord = SDL_FPoint { u_min, v_max };
+
+	out_vertices[0].color = tint;
+	out_vertices[1].color = tint;
+	out_vertices[2].color = tint;
+	out_vertices[3].color = tint;
+}
+
+struct ITU_RenderVerticesJob
+{
+	SDLContext*           context;
+	ITU_RenderSpriteItem* items;
+	float                 alpha; // interpolation factor between `transform_prev` and `transform`
+};
+
+// shortest path between two angles, so that interpolating across +-PI doesn't spin the sprite the long way around
+static float itu_sys_render_lerp_angle(float a, float b, float t)
+{
+	float diff = SDL_fmodf(b - a, 2 * SDL_PI_F);
+	if(diff > SDL_PI_F)
+		diff -= 2 * SDL_PI_F;
+	else if(diff < -SDL_PI_F)
+		diff += 2 * SDL_PI_F;
+	return a + diff * t;
+}
+
+void itu_sys_render_sprite_build_vertices_job(int item_beg, int item_end, Uint32 worker_index, void* user_data)
+{
+	ITU_RenderVerticesJob* job = (ITU_RenderVerticesJob*)user_data;
+
+	for(int i = item_beg; i < item_end; ++i)
+	{
+		ITU_RenderSpriteItem item = job->items[i];
+		if(job->alpha < 1)
+		{
+			item.transform.position = lerp(item.transform_prev.position, item.transform.position, job->alpha);
+			item.transform.scale    = lerp(item.transform_prev.scale, item.transform.scale, job->alpha);
+			item.transform.rotation = itu_sys_render_lerp_angle(item.transform_prev.rotation, item.transform.rotation, job->alpha);
+		}
+		itu_sys_render_sprite_build_vertices(job->context, &item, &sys_render_data.sprite_vertices[i * 4]);
+	}
+}
+
+// builds vertices for the given (sorted) items and submits one draw per run of sprites sharing the same state
+static void itu_sys_render_sprite_submit(SDLContext* context, ITU_RenderSpriteItem* items, int items_count, float alpha)
+{
+	if(items_count == 0)
+		return;
+
+	// grow shared index buffer if needed
+	int indices_count_old = stbds_arrlen(sys_render_data.sprite_indices);
+	if(indices_count_old < items_count * 6)
+	{
+		stbds_arrsetlen(sys_render_data.sprite_indices, items_count * 6);
+		for(int i = indices_count_old / 6; i < items_count; ++i)
+		{
+			int* quad_indices = &sys_render_data.sprite_indices[i * 6];
+			quad_indices[0] = i * 4 + 0;
+			quad_indices[1] = i * 4 + 1;
+			quad_indices[2] = i * 4 + 2;
+			quad_indices[3] = i * 4 + 0;
+			quad_indices[4] = i * 4 + 2;
+			quad_indices[5] = i * 4 + 3;
+		}
+	}
+
+	// vertex buffer is sized upfront, so that every job can write its own slice
+	stbds_arrsetlen(sys_render_data.sprite_vertices, items_count * 4);
+	SDL_Vertex* vertices = sys_render_data.sprite_vertices;
+	ITU_RenderVerticesJob job = { context, items, alpha };
+	itu_sys_jobs_parallel_for(itu_sys_render_sprite_build_vertices_job, items_count, ITU_RENDER_SPRITES_PER_JOB_MIN, &job);
+
+	int run_beg = 0;
+	while(run_beg < items_count)
+	{
+		int run_end = run_beg + 1;
+		while(
+			run_end < items_count &&
+			items[run_end].sprite.layer   == items[run_beg].sprite.layer &&
+			items[run_end].blend_mode     == items[run_beg].blend_mode &&
+			items[run_end].sprite.texture == items[run_beg].sprite.texture
+		)
+			++run_end;
+
+		SDL_Texture* texture = items[run_beg].sprite.texture;
+		int run_count = run_end - run_beg;
+
+		sdl_set_texture_tint(texture, COLOR_WHITE);
+		itu_sys_renderstats_render_geometry(
+			context,
+			texture,
+			&vertices[run_beg * 4], run_count * 4,
+			sys_render_data.sprite_indices, run_count * 6
+		);
+
+		run_beg = run_end;
+	}
+}
+
+// moves the queued sprites into the write snapshot and makes it the latest complete one
+static void itu_sys_render_snapshot_publish(SDLContext* context)
+{
+	ITU_RenderSpriteItem* items = sys_render_data.sprite_items;
+	int items_count = stbds_arrlen(items);
+
+	Uint64 tick = ++sys_render_data.snapshot_tick;
+
+	// previous transforms, only if the same key was published in the previous tick
+	// (otherwise the object just appeared, and interpolating from a stale position would make it fly in)
+	for(int i = 0; i < items_count; ++i)
+	{
+		Uint32 key = items[i].interpolation_key;
+		if(key == ITU_RENDER_INTERPOLATION_KEY_NONE)
+			continue;
+
+		int keys_count = stbds_arrlen(sys_render_data.interpolation_ticks);
+		if(key >= (Uint32)keys_count)
+		{
+			stbds_arrsetlen(sys_render_data.interpolation_transforms, key + 1);
+			stbds_arrsetlen(sys_render_data.interpolation_ticks, key + 1);
+			for(int k = keys_count; k <= (int)key; ++k)
+				sys_render_data.interpolation_ticks[k] = 0;
+		}
+
+		if(sys_render_data.interpolation_ticks[key] == tick - 1)
+			items[i].transform_prev = sys_render_data.interpolation_transforms[key];
+		sys_render_data.interpolation_transforms[key] = items[i].transform;
+		sys_render_data.interpolation_ticks[key] = tick;
+	}
+
+	ITU_RenderSnapshot* snapshot = &sys_render_data.snapshots[sys_render_data.snapshot_write];
+
+	// swap item arrays instead of copying them, the old snapshot array becomes the next queue
+	sys_render_data.sprite_items = snapshot->sprite_items;
+	snapshot->sprite_items = items;
+	stbds_arrsetlen(sys_render_data.sprite_items, 0);
+
+	snapshot->camera = *context->camera_active;
+	snapshot->camera_prev = tick == 1 ? snapshot->camera : sys_render_data.snapshot_camera_prev;
+	sys_render_data.snapshot_camera_prev = snapshot->camera;
+	snapshot->time_published = SDL_GetTicksNS();
+	snapshot->tick_duration = context->elapsed_frame;
+	snapshot->tick = tick;
+
+	int ready_prev = SDL_SetAtomicInt(&sys_render_data.snapshot_ready, sys_render_data.snapshot_write | ITU_RENDER_SNAPSHOT_FLAG_NEW);
+	sys_render_data.snapshot_write = ready_prev & ~ITU_RENDER_SNAPSHOT_FLAG_NEW;
+}
+
+void itu_sys_render_sprite_flush(SDLContext* context)
+{
+	ITU_RenderSpriteItem* items = sys_render_data.sprite_items;
+	int items_count = stbds_arrlen(items);
+
+	SDL_qsort(items, items_count, sizeof(ITU_RenderSpriteItem), itu_sys_render_sprite_item_compare);
+
+	// NOTE: in snapshot mode we publish even if there is nothing to draw, so that the render thread sees an empty frame
+	if(sys_render_data.snapshot_mode)
+	{
+		itu_sys_render_snapshot_publish(context);
+		return;
+	}
+
+	itu_sys_render_sprite_submit(context, items, items_count, 1);
+	stbds_arrsetlen(sys_render_data.sprite_items, 0);
+}
+
+// NOTE: needs to be called before the simulation thread starts, and after it stops
+void itu_sys_render_snapshot_enable(bool enabled)
+{
+	sys_render_data.snapshot_mode = enabled;
+	sys_render_data.snapshot_write = 0;
+	sys_render_data.snapshot_read  = 2;
+	sys_render_data.snapshot_tick  = 0;
+	SDL_SetAtomicInt(&sys_render_data.snapshot_ready, 1);
+	for(int i = 0; i < ITU_RENDER_SNAPSHOTS_COUNT; ++i)
+	{
+		stbds_arrsetlen(sys_render_data.snapshots[i].sprite_items, 0);
+		sys_render_data.snapshots[i].tick = 0;
+	}
+	stbds_arrsetlen(sys_render_data.interpolation_ticks, 0);
+	stbds_arrsetlen(sys_render_data.interpolation_transforms, 0);
+}
+
+bool itu_sys_render_snapshot_is_enabled()
+{
+	return sys_render_data.snapshot_mode;
+}
+
+// renders the latest complete snapshot, interpolated. Must be called from the render thread.
+// Returns false if no snapshot has been published yet
+bool itu_sys_render_snapshot_render(SDLContext* context)
+{
+	// grab the latest snapshot only if it's newer than the one we have, giving back ours to the simulation thread
+	if(SDL_GetAtomicInt(&sys_render_data.snapshot_ready) & ITU_RENDER_SNAPSHOT_FLAG_NEW)
+		sys_render_data.snapshot_read = SDL_SetAtomicInt(&sys_render_data.snapshot_ready, sys_render_data.snapshot_read) & ~ITU_RENDER_SNAPSHOT_FLAG_NEW;
+
+	ITU_RenderSnapshot* snapshot = &sys_render_data.snapshots[sys_render_data.snapshot_read];
+	if(snapshot->tick == 0)
+		return false;
+
+	// how far we are from the moment the current tick was published, relative to the tick length.
+	// We render "one tick in the past", so 0 draws the previous tick state and 1 the current one
+	float alpha = 1;
+	if(snapshot->tick_duration > 0)
+		alpha = SDL_clamp((float)(SDL_GetTicksNS() - snapshot->time_published) / (float)snapshot->tick_duration, 0.0f, 1.0f);
+
+	Camera camera = snapshot->camera;
+	camera.world_position = lerp(snapshot->camera_prev.world_position, snapshot->camera.world_position, alpha);
+	camera.zoom           = lerp(snapshot->camera_prev.zoom, snapshot->camera.zoom, alpha);
+
+	// camera position and zoom are interpolated like sprites, everything else (window size, render scale `context->zoom`,
+	// renderer) comes from the render thread context
+	SDLContext context_render = *context;
+	context_render.camera_active = &camera;
+
+	itu_sys_render_sprite_submit(&context_render, snapshot->sprite_items, stbds_arrlen(snapshot->sprite_items), alpha);
+
+	return true;
+}
+
+#endif // (defined ITU_SYS_RENDER_IMPLEMENTATION) || (defined ITU_UNITY_BUILD)
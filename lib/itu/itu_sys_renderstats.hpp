@@ -0,0 +1,376 @@
+// itu_sys_renderstats.hpp
+// render instrumentation: counts, every frame, draw submissions, vertices, texture switches, blend mode switches and
+// (estimated) pixels filled, both in total and broken down by scope (ECS systems are scoped automatically, by name).
+// Draws are counted when they go through the `itu_sys_renderstats_render_*` wrappers (used by sprite batcher, particles,
+// text and `itu_lib_sprite_render`), or when they are reported with `itu_sys_renderstats_record`
+//
+// overdraw view: when enabled, the frame starts black and every wrapped draw is replaced by its untextured geometry, added
+// on top of what is already there with a flat color. The brighter the pixel, the more times it has been filled
+//
+// usage (every frame)
+// - `itu_sys_renderstats_frame_begin` after clearing the screen (stats of the previous frame become the "last" ones)
+// - `itu_sys_renderstats_scope_begin` / `itu_sys_renderstats_scope_end` around code that is not a system (ie, particles)
+// - `itu_sys_renderstats_debug_ui_render` or `itu_sys_renderstats_log` to show the last frame
+//
+// limitations
+// - pixels filled is the area of the submitted triangles (rects for textures), without clipping to the viewport or
+//   discarding transparent texels. It's an upper bound of the actual fill-rate cost
+// - scopes don't nest
+// - only the thread calling `itu_sys_renderstats_frame_begin` (the render thread) is measured, scopes opened by other
+//   threads (ie, systems running on the simulation thread) are ignored
+// - the overdraw view draws textures (`itu_sys_renderstats_render_texture_rotated`) as their unrotated destination rect
+
+#ifndef ITU_SYS_RENDERSTATS_HPP
+#define ITU_SYS_RENDERSTATS_HPP
+
+#ifndef ITU_UNITY_BUILD
+#include <SDL3/SDL.h>
+#include <stb_ds.h>
+#include <imgui/imgui.h>
+#include <itu_common.hpp>
+#include <itu_lib_engine.hpp>
+#endif
+
+#define ITU_RENDERSTATS_SCOPES_MAX     32
+#define ITU_RENDERSTATS_SCOPE_NONE     "(unscoped)"
+#define ITU_RENDERSTATS_OVERDRAW_STEP  0.125f // heat added by every fill, 8 layers saturate
+
+struct ITU_RenderStats
+{
+	int    draw_calls;
+	int    vertices;
+	int    texture_switches;
+	int    blend_switches;
+	double pixels_filled;
+};
+
+void itu_sys_renderstats_set_enabled(bool enabled);
+bool itu_sys_renderstats_is_enabled();
+void itu_sys_renderstats_set_overdraw(bool enabled);
+bool itu_sys_renderstats_is_overdraw();
+void itu_sys_renderstats_frame_begin(SDLContext* context);
+void itu_sys_renderstats_scope_begin(const char* name);
+void itu_sys_renderstats_scope_end();
+void itu_sys_renderstats_record(SDLContext* context, SDL_Texture* texture, SDL_BlendMode blend_mode, int vertices_count, float pixels_filled);
+bool itu_sys_renderstats_render_geometry(SDLContext* context, SDL_Texture* texture, const SDL_Vertex* vertices, int vertices_count, const int* indices, int indices_count);
+bool itu_sys_renderstats_render_texture_rotated(SDLContext* context, SDL_Texture* texture, const SDL_FRect* rect_src, const SDL_FRect* rect_dst, double angle, const SDL_FPoint* center, SDL_FlipMode flip);
+ITU_RenderStats itu_sys_renderstats_get_last();
+void itu_sys_renderstats_log();
+void itu_sys_renderstats_debug_ui_render();
+
+#endif // ITU_SYS_RENDERSTATS_HPP
+
+#if (defined ITU_SYS_RENDERSTATS_IMPLEMENTATION) || (defined ITU_UNITY_BUILD)
+
+struct ITU_RenderStatsScope
+{
+	const char*     name;
+	ITU_RenderStats stats_curr;
+	ITU_RenderStats stats_last;
+};
+
+struct SysRenderStats
+{
+	bool enabled;
+	bool overdraw;
+
+	ITU_RenderStatsScope scopes[ITU_RENDERSTATS_SCOPES_MAX];
+	int scopes_count;
+	int scope_active;
+	SDL_ThreadID thread_id;
+
+	ITU_RenderStats total_curr;
+	ITU_RenderStats total_last;
+	float output_pixels_last;
+
+	// state of the previous draw, to detect switches
+	bool          has_draw_prev;
+	SDL_Texture*  texture_prev;
+	SDL_BlendMode blend_mode_prev;
+
+	stbds_arr(SDL_Vertex) overdraw_vertices;
+};
+
+SysRenderStats sys_renderstats_data;
+
+void itu_sys_renderstats_set_enabled(bool enabled)
+{
+	sys_renderstats_data.enabled = enabled;
+	if(!enabled)
+		sys_renderstats_data.overdraw = false;
+}
+
+bool itu_sys_renderstats_is_enabled()
+{
+	return sys_renderstats_data.enabled;
+}
+
+void itu_sys_renderstats_set_overdraw(bool enabled)
+{
+	sys_renderstats_data.overdraw = enabled;
+	if(enabled)
+		sys_renderstats_data.enabled = true;
+}
+
+bool itu_sys_renderstats_is_overdraw()
+{
+	return sys_renderstats_data.overdraw;
+}
+
+// scope 0 collects everything that is drawn outside of any scope
+static void itu_sys_renderstats_scopes_init()
+{
+	if(sys_renderstats_data.scopes_count == 0)
+	{
+		sys_renderstats_data.scopes[0].name = ITU_RENDERSTATS_SCOPE_NONE;
+		sys_renderstats_data.scopes_count = 1;
+	}
+}
+
+void itu_sys_renderstats_frame_begin(SDLContext* context)
+{
+	itu_sys_renderstats_scopes_init();
+
+	for(int i = 0; i < sys_renderstats_data.scopes_count; ++i)
+	{
+		ITU_RenderStatsScope* scope = &sys_renderstats_data.scopes[i];
+		scope->stats_last = scope->stats_curr;
+		scope->stats_curr = { 0 };
+	}
+	sys_renderstats_data.total_last = sys_renderstats_data.total_curr;
+	sys_renderstats_data.total_curr = { 0 };
+	sys_renderstats_data.scope_active = 0;
+	sys_renderstats_data.has_draw_prev = false;
+	sys_renderstats_data.thread_id = SDL_GetCurrentThreadID();
+
+	int output_w, output_h;
+	SDL_GetCurrentRenderOutputSize(context->renderer, &output_w, &output_h);
+	sys_renderstats_data.output_pixels_last = (float)output_w * output_h;
+
+	if(sys_renderstats_data.overdraw)
+	{
+		SDL_SetRenderDrawColor(context->renderer, 0x00, 0x00, 0x00, 0xFF);
+		SDL_RenderClear(context->renderer);
+	}
+}
+
+void itu_sys_renderstats_scope_begin(const char* name)
+{
+	if(SDL_GetCurrentThreadID() != sys_renderstats_data.thread_id)
+		return;
+
+	SDL_assert(sys_renderstats_data.scope_active == 0 && "render stats scopes don't nest");
+	itu_sys_renderstats_scopes_init();
+
+	for(int i = 0; i < sys_renderstats_data.scopes_count; ++i)
+	{
+		const char* scope_name = sys_renderstats_data.scopes[i].name;
+		if(scope_name == name || SDL_strcmp(scope_name, name) == 0)
+		{
+			sys_renderstats_data.scope_active = i;
+			return;
+		}
+	}
+
+	if(sys_renderstats_data.scopes_count == ITU_RENDERSTATS_SCOPES_MAX)
+	{
+		SDL_Log("WARNING render stats scopes limit reached, '%s' will be counted as unscoped", name);
+		return;
+	}
+
+	int index = sys_renderstats_data.scopes_count++;
+	sys_renderstats_data.scopes[index] = { 0 };
+	sys_renderstats_data.scopes[index].name = name;
+	sys_renderstats_data.scope_active = index;
+}
+
+void itu_sys_renderstats_scope_end()
+{
+	if(SDL_GetCurrentThreadID() != sys_renderstats_data.thread_id)
+		return;
+
+	sys_renderstats_data.scope_active = 0;
+}
+
+static void itu_sys_renderstats_add(ITU_RenderStats* stats, int vertices_count, float pixels_filled, bool texture_switch, bool blend_switch)
+{
+	stats->draw_calls++;
+	stats->vertices += vertices_count;
+	stats->pixels_filled += pixels_filled;
+	if(texture_switch)
+		stats->texture_switches++;
+	if(blend_switch)
+		stats->blend_switches++;
+}
+
+// for draws that don't go through the wrappers (ie, compositing a cached target). `pixels_filled` is in output pixels
+void itu_sys_renderstats_record(SDLContext* context, SDL_Texture* texture, SDL_BlendMode blend_mode, int vertices_count, float pixels_filled)
+{
+	if(!sys_renderstats_data.enabled)
+		return;
+
+	itu_sys_renderstats_scopes_init();
+
+	// the first draw of the frame is not a switch, we don't know what was bound before
+	bool texture_switch = sys_renderstats_data.has_draw_prev && texture != sys_renderstats_data.texture_prev;
+	bool blend_switch   = sys_renderstats_data.has_draw_prev && blend_mode != sys_renderstats_data.blend_mode_prev;
+	sys_renderstats_data.has_draw_prev = true;
+	sys_renderstats_data.texture_prev = texture;
+	sys_renderstats_data.blend_mode_prev = blend_mode;
+
+	ITU_RenderStatsScope* scope = &sys_renderstats_data.scopes[sys_renderstats_data.scope_active];
+	itu_sys_renderstats_add(&scope->stats_curr, vertices_count, pixels_filled, texture_switch, blend_switch);
+	itu_sys_renderstats_add(&sys_renderstats_data.total_curr, vertices_count, pixels_filled, texture_switch, blend_switch);
+}
+
+// same as `SDL_RenderGeometry`, but counted (and drawn as heat in overdraw view)
+bool itu_sys_renderstats_render_geometry(SDLContext* context, SDL_Texture* texture, const SDL_Vertex* vertices, int vertices_count, const int* indices, int indices_count)
+{
+	if(!sys_renderstats_data.enabled)
+		return SDL_RenderGeometry(context->renderer, texture, vertices, vertices_count, indices, indices_count);
+
+	SDL_BlendMode blend_mode;
+	if(texture)
+		SDL_GetTextureBlendMode(texture, &blend_mode);
+	else
+		SDL_GetRenderDrawBlendMode(context->renderer, &blend_mode);
+
+	// triangles area, in output pixels
+	float area = 0;
+	int triangle_vertices_count = indices ? indices_count : vertices_count;
+	for(int i = 0; i + 2 < triangle_vertices_count; i += 3)
+	{
+		SDL_FPoint a = vertices[indices ? indices[i + 0] : i + 0].position;
+		SDL_FPoint b = vertices[indices ? indices[i + 1] : i + 1].position;
+		SDL_FPoint c = vertices[indices ? indices[i + 2] : i + 2].position;
+		area += SDL_fabsf((b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y)) * 0.5f;
+	}
+	vec2f scale;
+	SDL_GetRenderScale(context->renderer, &scale.x, &scale.y);
+
+	itu_sys_renderstats_record(context, texture, blend_mode, triangle_vertices_count, area * scale.x * scale.y);
+
+	if(!sys_renderstats_data.overdraw)
+		return SDL_RenderGeometry(context->renderer, texture, vertices, vertices_count, indices, indices_count);
+
+	stbds_arrsetlen(sys_renderstats_data.overdraw_vertices, vertices_count);
+	for(int i = 0; i < vertices_count; ++i)
+	{
+		SDL_Vertex* vertex = &sys_renderstats_data.overdraw_vertices[i];
+		vertex->position = vertices[i].position;
+		vertex->color = SDL_FColor { ITU_RENDERSTATS_OVERDRAW_STEP, ITU_RENDERSTATS_OVERDRAW_STEP, ITU_RENDERSTATS_OVERDRAW_STEP, 1 };
+		vertex->tex_coord = vertices[i].tex_coord;
+	}
+
+	// NOTE: untextured geometry uses the draw blend mode
+	SDL_BlendMode blend_mode_prev;
+	SDL_GetRenderDrawBlendMode(context->renderer, &blend_mode_prev);
+	SDL_SetRenderDrawBlendMode(context->renderer, SDL_BLENDMODE_ADD);
+	bool ret = SDL_RenderGeometry(context->renderer, NULL, sys_renderstats_data.overdraw_vertices, vertices_count, indices, indices_count);
+	SDL_SetRenderDrawBlendMode(context->renderer, blend_mode_prev);
+
+	return ret;
+}
+
+// same as `SDL_RenderTextureRotated`, but counted (and drawn as heat in overdraw view)
+bool itu_sys_renderstats_render_texture_rotated(SDLContext* context, SDL_Texture* texture, const SDL_FRect* rect_src, const SDL_FRect* rect_dst, double angle, const SDL_FPoint* center, SDL_FlipMode flip)
+{
+	if(!sys_renderstats_data.enabled)
+		return SDL_RenderTextureRotated(context->renderer, texture, rect_src, rect_dst, angle, center, flip);
+
+	SDL_BlendMode blend_mode;
+	SDL_GetTextureBlendMode(texture, &blend_mode);
+	vec2f scale;
+	SDL_GetRenderScale(context->renderer, &scale.x, &scale.y);
+
+	itu_sys_renderstats_record(context, texture, blend_mode, 4, rect_dst->w * rect_dst->h * scale.x * scale.y);
+
+	if(!sys_renderstats_data.overdraw)
+		return SDL_RenderTextureRotated(context->renderer, texture, rect_src, rect_dst, angle, center, flip);
+
+	Uint8 r, g, b, a;
+	SDL_BlendMode blend_mode_prev;
+	SDL_GetRenderDrawColor(context->renderer, &r, &g, &b, &a);
+	SDL_GetRenderDrawBlendMode(context->renderer, &blend_mode_prev);
+	SDL_SetRenderDrawColorFloat(context->renderer, ITU_RENDERSTATS_OVERDRAW_STEP, ITU_RENDERSTATS_OVERDRAW_STEP, ITU_RENDERSTATS_OVERDRAW_STEP, 1);
+	SDL_SetRenderDrawBlendMode(context->renderer, SDL_BLENDMODE_ADD);
+	bool ret = SDL_RenderFillRect(context->renderer, rect_dst);
+	SDL_SetRenderDrawBlendMode(context->renderer, blend_mode_prev);
+	SDL_SetRenderDrawColor(context->renderer, r, g, b, a);
+
+	return ret;
+}
+
+ITU_RenderStats itu_sys_renderstats_get_last()
+{
+	return sys_renderstats_data.total_last;
+}
+
+// logs the stats of the last frame, by scope
+void itu_sys_renderstats_log()
+{
+	SDL_Log("render stats (last frame)");
+	SDL_Log("  %-32s %8s %8s %8s %8s %10s", "scope", "draws", "vertices", "tex sw", "blend sw", "Mpixels");
+	for(int i = 0; i < sys_renderstats_data.scopes_count; ++i)
+	{
+		ITU_RenderStatsScope* scope = &sys_renderstats_data.scopes[i];
+		ITU_RenderStats* stats = &scope->stats_last;
+		if(stats->draw_calls == 0)
+			continue;
+		SDL_Log("  %-32s %8d %8d %8d %8d %10.3f", scope->name, stats->draw_calls, stats->vertices, stats->texture_switches, stats->blend_switches, stats->pixels_filled / 1000000.0);
+	}
+
+	ITU_RenderStats* total = &sys_renderstats_data.total_last;
+	SDL_Log("  %-32s %8d %8d %8d %8d %10.3f", "total", total->draw_calls, total->vertices, total->texture_switches, total->blend_switches, total->pixels_filled / 1000000.0);
+	if(sys_renderstats_data.output_pixels_last > 0)
+		SDL_Log("  overdraw: %.2fx", total->pixels_filled / sys_renderstats_data.output_pixels_last);
+}
+
+void itu_sys_renderstats_debug_ui_render()
+{
+	bool enabled = sys_renderstats_data.enabled;
+	bool overdraw = sys_renderstats_data.overdraw;
+	if(ImGui::Checkbox("collect", &enabled))
+		itu_sys_renderstats_set_enabled(enabled);
+	ImGui::SameLine();
+	if(ImGui::Checkbox("overdraw view", &overdraw))
+		itu_sys_renderstats_set_overdraw(overdraw);
+
+	if(!sys_renderstats_data.enabled)
+		return;
+
+	ITU_RenderStats* total = &sys_renderstats_data.total_last;
+	if(sys_renderstats_data.output_pixels_last > 0)
+		ImGui::LabelText("overdraw", "%.2fx", total->pixels_filled / sys_renderstats_data.output_pixels_last);
+
+	if(ImGui::BeginTable("debug_renderstats", 6, ImGuiTableFlags_SizingFixedFit | ImGuiTableFlags_RowBg))
+	{
+		ImGui::TableSetupColumn("scope");
+		ImGui::TableSetupColumn("draws");
+		ImGui::TableSetupColumn("vertices");
+		ImGui::TableSetupColumn("tex sw");
+		ImGui::TableSetupColumn("blend sw");
+		ImGui::TableSetupColumn("Mpixels");
+		ImGui::TableHeadersRow();
+
+		for(int i = 0; i <= sys_renderstats_data.scopes_count; ++i)
+		{
+			bool is_total = i == sys_renderstats_data.scopes_count;
+			const char* name = is_total ? "total" : sys_renderstats_data.scopes[i].name;
+			ITU_RenderStats* stats = is_total ? total : &sys_renderstats_data.scopes[i].stats_last;
+			if(!is_total && stats->draw_calls == 0)
+				continue;
+
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn(); ImGui::Text("%s", name);
+			ImGui::TableNextColumn(); ImGui::Text("%d", stats->draw_calls);
+			ImGui::TableNextColumn(); ImGui::Text("%d", stats->vertices);
+			ImGui::TableNextColumn(); ImGui::Text("%d", stats->texture_switches);
+			ImGui::TableNextColumn(); ImGui::Text("%d", stats->blend_switches);
+			ImGui::TableNextColumn(); ImGui::Text("%.3f", stats->pixels_filled / 1000000.0);
+		}
+		ImGui::EndTable();
+	}
+}
+
+#endif // (defined ITU_SYS_RENDERSTATS_IMPLEMENTATION) || (defined ITU_UNITY_BUILD)
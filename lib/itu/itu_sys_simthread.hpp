@@ -0,0 +1,193 @@
+// itu_sys_simthread.hpp
+// runs the simulation (game logic, physics, render queueing) on its own thread at a fixed tick rate,
+// so that the main thread only has to process events and render. The two threads communicate through:
+// - input: the main thread pushes its input state after processing events, the simulation reads it at the beginning of every tick
+//   (button presses happening between two ticks are accumulated, so they are never lost)
+// - rendering: `itu_sys_render` snapshot mode. The sprite batcher publishes a snapshot at the end of every tick, the main thread
+//   draws the latest one with `itu_sys_render_snapshot_render`
+//
+// the simulation thread works on its own copy of SDLContext (taken when the thread starts), without renderer and window.
+//
+// limitations
+// - systems running on the simulation thread must not use the SDL renderer (and the debug-draw queue in `itu_lib_render`)
+// - tilemap chunks are not baked on the simulation thread, bake them before starting it (see `itu_lib_tilemap_bake_all`)
+// - entities, components and resources are owned by the simulation thread while it runs (ie, no debug UI)
+
+#ifndef ITU_SYS_SIMTHREAD_HPP
+#define ITU_SYS_SIMTHREAD_HPP
+
+#ifndef ITU_UNITY_BUILD
+#include <SDL3/SDL.h>
+#include <itu_common.hpp>
+#include <itu_lib_engine.hpp>
+#include <itu_sys_render.hpp>
+#endif
+
+// if the simulation falls more than this many ticks behind, it skips them instead of trying to catch up
+#define ITU_SIMTHREAD_MAX_TICKS_BEHIND 4
+
+typedef void (*ITU_SimUpdateFunction)(SDLContext* context, void* user_data);
+
+bool   itu_sys_simthread_start(SDLContext* context, SDL_Time tick_nsecs, ITU_SimUpdateFunction fn_update, void* user_data);
+void   itu_sys_simthread_stop();
+bool   itu_sys_simthread_is_running();
+void   itu_sys_simthread_input_push(SDLContext* context);
+Uint64 itu_sys_simthread_get_ticks_count();
+
+#endif // ITU_SYS_SIMTHREAD_HPP
+
+#if (defined ITU_SYS_SIMTHREAD_IMPLEMENTATION) || (defined ITU_UNITY_BUILD)
+
+struct SysSimThread
+{
+	SDL_Thread* thread;
+	SDL_AtomicInt quit;
+	SDL_AtomicInt ticks_count;
+
+	SDLContext context; // owned by the simulation thread
+	SDL_Time   tick_nsecs;
+	ITU_SimUpdateFunction fn_update;
+	void*      user_data;
+
+	// input staging, written by the main thread and consumed by the simulation thread
+	SDL_Mutex* mutex_input;
+	bool  btn_isdown[BTN_TYPE_MAX];
+	bool  btn_isjustpressed[BTN_TYPE_MAX];
+	vec2f mouse_pos;
+	float mouse_scroll;
+	float window_w;
+	float window_h;
+	bool  debug_ui_show;
+};
+
+SysSimThread sys_simthread_data;
+
+static void itu_sys_simthread_input_pull(SDLContext* context)
+{
+	SDL_LockMutex(sys_simthread_data.mutex_input);
+	SDL_memcpy(context->btn_isdown, sys_simthread_data.btn_isdown, sizeof(context->btn_isdown));
+	SDL_memcpy(context->btn_isjustpressed, sys_simthread_data.btn_isjustpressed, sizeof(context->btn_isjustpressed));
+	context->mouse_pos = sys_simthread_data.mouse_pos;
+	context->mouse_scroll = sys_simthread_data.mouse_scroll;
+	context->window_w = sys_simthread_data.window_w;
+	context->window_h = sys_simthread_data.window_h;
+	context->debug_ui_show = sys_simthread_data.debug_ui_show;
+
+	SDL_memset(sys_simthread_data.btn_isjustpressed, 0, sizeof(sys_simthread_data.btn_isjustpressed));
+	sys_simthread_data.mouse_scroll = 0;
+	SDL_UnlockMutex(sys_simthread_data.mutex_input);
+}
+
+int itu_sys_simthread_main(void* data)
+{
+	SDLContext* context = &sys_simthread_data.context;
+	SDL_Time tick_nsecs = sys_simthread_data.tick_nsecs;
+
+	SDL_Time time_next = SDL_GetTicksNS();
+	while(!SDL_GetAtomicInt(&sys_simthread_data.quit))
+	{
+		SDL_Time now = SDL_GetTicksNS();
+		if(now < time_next)
+		{
+			SDL_DelayNS(time_next - now);
+			continue;
+		}
+
+		// spiral of death protection: when simulation can't keep up we slow it down instead of accumulating delay
+		if(now - time_next > tick_nsecs * ITU_SIMTHREAD_MAX_TICKS_BEHIND)
+			time_next = now;
+		time_next += tick_nsecs;
+
+		itu_sys_simthread_input_pull(context);
+
+		context->elapsed_frame = tick_nsecs;
+		context->delta = NS_TO_SECONDS(tick_nsecs);
+		context->uptime += context->delta;
+
+		sys_simthread_data.fn_update(context, sys_simthread_data.user_data);
+		SDL_AddAtomicInt(&sys_simthread_data.ticks_count, 1);
+	}
+
+	return 0;
+}
+
+// starts running `fn_update` every `tick_nsecs` on a new thread (usually calling `itu_sys_estorage_systems_update`)
+// and switches `itu_sys_render` to snapshot mode.
+// NOTE: if the active camera is the context default camera the simulation uses its own copy of it,
+//       any other camera is shared, and must only be touched by the simulation from now on
+bool itu_sys_simthread_start(SDLContext* context, SDL_Time tick_nsecs, ITU_SimUpdateFunction fn_update, void* user_data)
+{
+	SDL_assert(!sys_simthread_data.thread);
+	SDL_assert(fn_update && tick_nsecs > 0);
+
+	sys_simthread_data.context = *context;
+	sys_simthread_data.context.window = NULL;
+	sys_simthread_data.context.renderer = NULL;
+	if(context->camera_active == &context->camera_default)
+		sys_simthread_data.context.camera_active = &sys_simthread_data.context.camera_default;
+
+	sys_simthread_data.tick_nsecs = tick_nsecs;
+	sys_simthread_data.fn_update = fn_update;
+	sys_simthread_data.user_data = user_data;
+	sys_simthread_data.mutex_input = SDL_CreateMutex();
+	SDL_SetAtomicInt(&sys_simthread_data.quit, 0);
+	SDL_SetAtomicInt(&sys_simthread_data.ticks_count, 0);
+	itu_sys_simthread_input_push(context);
+
+	itu_sys_render_snapshot_enable(true);
+
+	sys_simthread_data.thread = SDL_CreateThread(itu_sys_simthread_main, "itu_simulation", NULL);
+	if(!sys_simthread_data.thread)
+	{
+		SDL_Log("ERROR creating simulation thread: %s", SDL_GetError());
+		itu_sys_render_snapshot_enable(false);
+		SDL_DestroyMutex(sys_simthread_data.mutex_input);
+		sys_simthread_data.mutex_input = NULL;
+		return false;
+	}
+
+	return true;
+}
+
+// waits for the current tick to finish and goes back to single-threaded mode
+void itu_sys_simthread_stop()
+{
+	if(!sys_simthread_data.thread)
+		return;
+
+	SDL_SetAtomicInt(&sys_simthread_data.quit, 1);
+	SDL_WaitThread(sys_simthread_data.thread, NULL);
+	sys_simthread_data.thread = NULL;
+
+	SDL_DestroyMutex(sys_simthread_data.mutex_input);
+	sys_simthread_data.mutex_input = NULL;
+
+	itu_sys_render_snapshot_enable(false);
+}
+
+bool itu_sys_simthread_is_running()
+{
+	return sys_simthread_data.thread != NULL;
+}
+
+// to be called by the main thread after `sdl_process_events`
+void itu_sys_simthread_input_push(SDLContext* context)
+{
+	SDL_LockMutex(sys_simthread_data.mutex_input);
+	SDL_memcpy(sys_simthread_data.btn_isdown, context->btn_isdown, sizeof(context->btn_isdown));
+	for(int i = 0; i < BTN_TYPE_MAX; ++i)
+		sys_simthread_data.btn_isjustpressed[i] |= context->btn_isjustpressed[i];
+	sys_simthread_data.mouse_pos = context->mouse_pos;
+	sys_simthread_data.mouse_scroll += context->mouse_scroll;
+	sys_simthread_data.window_w = context->window_w;
+	sys_simthread_data.window_h = context->window_h;
+	sys_simthread_data.debug_ui_show = context->debug_ui_show;
+	SDL_UnlockMutex(sys_simthread_data.mutex_input);
+}
+
+Uint64 itu_sys_simthread_get_ticks_count()
+{
+	return (Uint64)SDL_GetAtomicInt(&sys_simthread_data.ticks_count);
+}
+
+#endif // (defined ITU_SYS_SIMTHREAD_IMPLEMENTATION) || (defined ITU_UNITY_BUILD)
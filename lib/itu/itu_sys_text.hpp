@@ -0,0 +1,505 @@
+// itu_sys_text.hpp
+// batched text rendering with glyph atlases and cached layouts
+// - every font gets its own glyph atlas (one or more texture pages), glyphs are rasterized the first time they are used
+// - layouts (glyph positions for a whole string) are cached by (font, size, style, string). Drawing the same string again
+//   costs only a hash lookup. Layouts unused for a while are evicted, so changing strings (ie, timers) don't grow the cache forever
+// - queued text is drawn with one `SDL_RenderGeometry` call per atlas page when the queue is flushed
+//
+// text can be queued directly in screen space (HUD) or through the `Text` component (world-space anchor, screen-space size)
+//
+// limitations
+// - glyph cells are rasterized as single-character strings, so glyphs with a negative left bearing are slightly shifted right
+// - text from different atlas pages doesn't respect submission order (same as different textures in `itu_sys_render`)
+// - changing size or style of a font clears its atlas (glyphs will be rasterized again)
+
+#ifndef ITU_SYS_TEXT_HPP
+#define ITU_SYS_TEXT_HPP
+
+#ifndef ITU_UNITY_BUILD
+#include <SDL3/SDL.h>
+#include <SDL3_ttf/SDL_ttf.h>
+#include <stb_ds.h>
+#include <imgui/imstb_rectpack.h>
+#include <itu_common.hpp>
+#include <itu_lib_engine.hpp>
+#include <itu_sys_renderstats.hpp>
+#endif
+
+#define ITU_TEXT_LENGTH_MAX          64  // for the `Text` component only, queued strings can be of any length
+#define ITU_TEXT_ATLAS_PAGE_SIZE     512
+#define ITU_TEXT_ATLAS_PADDING       1
+#define ITU_TEXT_LAYOUT_UNUSED_MAX   120 // in flushes (~frames)
+
+struct Text
+{
+	TTF_Font* font;
+	char      text[ITU_TEXT_LENGTH_MAX];
+	color     tint;
+	vec2f     pivot;  // normalized, relative to the text bounds
+	vec2f     offset; // in pixels, from the transform position on screen
+	float     scale;  // NOTE: text size is in pixels, so it doesn't change with camera zoom
+};
+
+struct ITU_TextLayoutQuad
+{
+	SDL_Texture* texture; // atlas page
+	SDL_FRect    rect_src;
+	SDL_FRect    rect_dst; // relative to the top-left corner of the text
+};
+
+struct ITU_TextLayout
+{
+	char*     text; // owned copy, to detect hash collisions
+	TTF_Font* font;
+	float     font_size;
+	int       font_style;
+	vec2f     size; // in pixels
+	stbds_arr(ITU_TextLayoutQuad) quads;
+	Uint32    atlas_generation; // quads reference atlas pages, so they are stale if the atlas has been reset since
+	Uint64    flush_last_used;
+};
+
+void            itu_lib_text_init(Text* text, TTF_Font* font, const char* str);
+void            itu_lib_text_set(Text* text, const char* str);
+ITU_TextLayout* itu_sys_text_layout_get(SDLContext* context, TTF_Font* font, const char* str);
+vec2f           itu_sys_text_measure(SDLContext* context, TTF_Font* font, const char* str);
+void            itu_sys_text_queue(SDLContext* context, TTF_Font* font, const char* str, vec2f position, vec2f pivot, float scale, color tint);
+void            itu_sys_text_queue_layout(ITU_TextLayout* layout, vec2f position, vec2f pivot, float scale, color tint);
+void            itu_sys_text_flush(SDLContext* context);
+void            itu_sys_text_clear();
+
+#endif // ITU_SYS_TEXT_HPP
+
+#if (defined ITU_SYS_TEXT_IMPLEMENTATION) || (defined ITU_UNITY_BUILD)
+
+struct ITU_TextGlyph
+{
+	SDL_Texture* texture; // NULL for glyphs without pixels (ie, spaces)
+	SDL_FRect    rect;
+	float        advance;
+};
+
+// NOTE: pages are heap-allocated because `stbrp_context` keeps pointers to itself (same as atlas pages in resource storage)
+struct ITU_TextAtlasPage
+{
+	SDL_Texture*  texture;
+	stbrp_context packer;
+	stbrp_node    packer_nodes[ITU_TEXT_ATLAS_PAGE_SIZE];
+};
+
+struct ITU_TextFontAtlas
+{
+	float  font_size;
+	int    font_style;
+	Uint32 generation;
+	stbds_hm(Uint32, ITU_TextGlyph) glyphs;
+	stbds_arr(ITU_TextAtlasPage*)   pages;
+};
+
+struct ITU_TextQueuedQuad
+{
+	SDL_Texture* texture;
+	SDL_FRect    rect_src;
+	SDL_FRect    rect_dst;
+	SDL_FColor   tint;
+	int          order;
+};
+
+struct SysText
+{
+	stbds_hm(TTF_Font*, ITU_TextFontAtlas) atlases;
+	stbds_hm(Uint64, ITU_TextLayout*)      layouts;
+	Uint64 flushes_count;
+	Uint32 atlas_generation_next;
+
+	stbds_arr(ITU_TextQueuedQuad) queue;
+	stbds_arr(SDL_Vertex) vertices;
+	stbds_arr(int)        indices;
+};
+
+SysText sys_text_data;
+
+void itu_lib_text_init(Text* text, TTF_Font* font, const char* str)
+{
+	SDL_zerop(text);
+	text->font = font;
+	text->tint = COLOR_WHITE;
+	text->pivot = vec2f { 0.5f, 0.5f };
+	text->scale = 1;
+	itu_lib_text_set(text, str);
+}
+
+// NOTE: strings longer than ITU_TEXT_LENGTH_MAX-1 bytes are truncated
+void itu_lib_text_set(Text* text, const char* str)
+{
+	SDL_strlcpy(text->text, str, ITU_TEXT_LENGTH_MAX);
+}
+
+static void itu_sys_text_atlas_reset(ITU_TextFontAtlas* atlas)
+{
+	for(int i = 0; i < stbds_arrlen(atlas->pages); ++i)
+	{
+		SDL_DestroyTexture(atlas->pages[i]->texture);
+		SDL_free(atlas->pages[i]);
+	}
+	stbds_arrfree(atlas->pages);
+	stbds_hmfree(atlas->glyphs);
+}
+
+static ITU_TextFontAtlas* itu_sys_text_atlas_get(TTF_Font* font)
+{
+	float font_size  = TTF_GetFontSize(font);
+	int   font_style = TTF_GetFontStyle(font);
+
+	int idx = stbds_hmgeti(sys_text_data.atlases, font);
+	if(idx == -1)
+	{
+		ITU_TextFontAtlas atlas = { 0 };
+		atlas.font_size = font_size;
+		atlas.font_style = font_style;
+		atlas.generation = ++sys_text_data.atlas_generation_next;
+		stbds_hmput(sys_text_data.atlases, font, atlas);
+		idx = stbds_hmgeti(sys_text_data.atlases, font);
+	}
+
+	ITU_TextFontAtlas* atlas = &sys_text_data.atlases[idx].value;
+	if(atlas->font_size != font_size || atlas->font_style != font_style)
+	{
+		itu_sys_text_atlas_reset(atlas);
+		atlas->font_size = font_size;
+		atlas->font_style = font_style;
+		atlas->generation = ++sys_text_data.atlas_generation_next;
+	}
+
+	return atlas;
+}
+
+static ITU_TextAtlasPage* itu_sys_text_atlas_page_create(SDLContext* context, ITU_TextFontAtlas* atlas)
+{
+	const int size = ITU_TEXT_ATLAS_PAGE_SIZE;
+
+	SDL_Texture* texture = SDL_CreateTexture(context->renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, size, size);
+	if(!texture)
+	{
+		SDL_Log("ERROR creating glyph atlas page: %s", SDL_GetError());
+		return NULL;
+	}
+	SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+	void* pixels_clear = SDL_calloc(size * size, 4);
+	SDL_UpdateTexture(texture, NULL, pixels_clear, size * 4);
+	SDL_free(pixels_clear);
+
+	ITU_TextAtlasPage* page = (ITU_TextAtlasPage*)SDL_malloc(sizeof(ITU_TextAtlasPage));
+	page->texture = texture;
+	stbrp_init_target(&page->packer, size, size, page->packer_nodes, size);
+
+	stbds_arrput(atlas->pages, page);
+	return page;
+}
+
+// returns the glyph for the given codepoint, rasterizing it in the atlas if needed
+static ITU_TextGlyph itu_sys_text_glyph_get(SDLContext* context, TTF_Font* font, ITU_TextFontAtlas* atlas, Uint32 codepoint)
+{
+	int idx = stbds_hmgeti(atlas->glyphs, codepoint);
+	if(idx != -1)
+		return atlas->glyphs[idx].value;
+
+	ITU_TextGlyph glyph = { 0 };
+	int min_x, max_x, min_y, max_y, advance = 0;
+	TTF_GetGlyphMetrics(font, codepoint, &min_x, &max_x, &min_y, &max_y, &advance);
+	glyph.advance = (float)advance;
+
+	// white glyphs, color is applied with vertex colors
+	SDL_Surface* surface_glyph = TTF_RenderGlyph_Blended(font, codepoint, SDL_Color { 0xFF, 0xFF, 0xFF, 0xFF });
+	SDL_Surface* surface = surface_glyph ? SDL_ConvertSurface(surface_glyph, SDL_PIXELFORMAT_RGBA32) : NULL;
+	SDL_DestroySurface(surface_glyph);
+
+	if(surface && surface->w > 0 && surface->h > 0 && surface->w <= ITU_TEXT_ATLAS_PAGE_SIZE && surface->h <= ITU_TEXT_ATLAS_PAGE_SIZE)
+	{
+		stbrp_rect rect = { 0 };
+		rect.w = surface->w + ITU_TEXT_ATLAS_PADDING;
+		rect.h = surface->h + ITU_TEXT_ATLAS_PADDING;
+
+		// only the last page can have room left, older ones were full when it was created
+		ITU_TextAtlasPage* page = stbds_arrlen(atlas->pages) > 0 ? stbds_arrlast(atlas->pages) : NULL;
+		if(page)
+			stbrp_pack_rects(&page->packer, &rect, 1);
+		if(!page || !rect.was_packed)
+		{
+			page = itu_sys_text_atlas_page_create(context, atlas);
+			if(page)
+				stbrp_pack_rects(&page->packer, &rect, 1);
+		}
+
+		if(page && rect.was_packed)
+		{
+			SDL_Rect rect_upload = { rect.x, rect.y, surface->w, surface->h };
+			SDL_UpdateTexture(page->texture, &rect_upload, surface->pixels, surface->pitch);
+
+			glyph.texture = page->texture;
+			glyph.rect = SDL_FRect { (float)rect.x, (float)rect.y, (float)surface->w, (float)surface->h };
+		}
+	}
+	SDL_DestroySurface(surface);
+
+	stbds_hmput(atlas->glyphs, codepoint, glyph);
+	return glyph;
+}
+
+static void itu_sys_text_layout_build(SDLContext* context, ITU_TextLayout* layout, ITU_TextFontAtlas* atlas)
+{
+	stbds_arrsetlen(layout->quads, 0);
+	layout->atlas_generation = atlas->generation;
+
+	float line_height = (float)TTF_GetFontLineSkip(layout->font);
+	float pen_x = 0;
+	float pen_y = 0;
+	float size_x = 0;
+	Uint32 codepoint_prev = 0;
+
+	const char* str = layout->text;
+	size_t str_len = SDL_strlen(str);
+	while(str_len > 0)
+	{
+		Uint32 codepoint = SDL_StepUTF8(&str, &str_len);
+		if(codepoint == 0)
+			break;
+
+		if(codepoint == '\n')
+		{
+			pen_x = 0;
+			pen_y += line_height;
+			codepoint_prev = 0;
+			continue;
+		}
+
+		int kerning = 0;
+		if(codepoint_prev && TTF_GetGlyphKerning(layout->font, codepoint_prev, codepoint, &kerning))
+			pen_x += kerning;
+
+		ITU_TextGlyph glyph = itu_sys_text_glyph_get(context, layout->font, atlas, codepoint);
+		if(glyph.texture)
+		{
+			ITU_TextLayoutQuad quad;
+			quad.texture = glyph.texture;
+			quad.rect_src = glyph.rect;
+			quad.rect_dst = SDL_FRect { pen_x, pen_y, glyph.rect.w, glyph.rect.h };
+			stbds_arrput(layout->quads, quad);
+		}
+
+		pen_x += glyph.advance;
+		size_x = SDL_max(size_x, pen_x);
+		codepoint_prev = codepoint;
+	}
+
+	layout->size = vec2f { size_x, pen_y + line_height };
+}
+
+// returns the cached layout of the given string, building it if needed
+ITU_TextLayout* itu_sys_text_layout_get(SDLContext* context, TTF_Font* font, const char* str)
+{
+	ITU_TextFontAtlas* atlas = itu_sys_text_atlas_get(font);
+	float font_size  = atlas->font_size;
+	int   font_style = atlas->font_style;
+
+	struct { TTF_Font* font; float size; int style; } key_font = { font, font_size, font_style };
+	Uint64 key = stbds_hash_string((char*)str, stbds_hash_bytes(&key_font, sizeof(key_font), 0));
+
+	ITU_TextLayout* layout = stbds_hmget(sys_text_data.layouts, key);
+	bool valid =
+		layout &&
+		layout->font == font &&
+		layout->font_size == font_size &&
+		layout->font_style == font_style &&
+		layout->atlas_generation == atlas->generation &&
+		SDL_strcmp(layout->text, str) == 0;
+
+	if(!valid)
+	{
+		// new string, or a hash collision (in which case the old layout is simply replaced)
+		if(!layout)
+		{
+			layout = (ITU_TextLayout*)SDL_calloc(1, sizeof(ITU_TextLayout));
+			stbds_hmput(sys_text_data.layouts, key, layout);
+		}
+		SDL_free(layout->text);
+		layout->text = SDL_strdup(str);
+		layout->font = font;
+		layout->font_size = font_size;
+		layout->font_style = font_style;
+		itu_sys_text_layout_build(context, layout, atlas);
+	}
+
+	layout->flush_last_used = sys_text_data.flushes_count;
+	return layout;
+}
+
+// size in pixels of the given string
+vec2f itu_sys_text_measure(SDLContext* context, TTF_Font* font, const char* str)
+{
+	return itu_sys_text_layout_get(context, font, str)->size;
+}
+
+// queues the given string, `position` in screen space, `pivot` normalized on the text bounds
+void itu_sys_text_queue(SDLContext* context, TTF_Font* font, const char* str, vec2f position, vec2f pivot, float scale, color tint)
+{
+	itu_sys_text_queue_layout(itu_sys_text_layout_get(context, font, str), position, pivot, scale, tint);
+}
+
+// same as `itu_sys_text_queue`, for layouts already retrieved (ie, to check their size first)
+// NOTE: the layout is only valid until the next flush (unused layouts are evicted there)
+void itu_sys_text_queue_layout(ITU_TextLayout* layout, vec2f position, vec2f pivot, float scale, color tint)
+{
+	vec2f origin;
+	origin.x = position.x - pivot.x * layout->size.x * scale;
+	origin.y = position.y - pivot.y * layout->size.y * scale;
+
+	int quads_count = stbds_arrlen(layout->quads);
+	for(int i = 0; i < quads_count; ++i)
+	{
+		ITU_TextLayoutQuad* quad = &layout->quads[i];
+
+		ITU_TextQueuedQuad queued;
+		queued.texture = quad->texture;
+		queued.rect_src = quad->rect_src;
+		queued.rect_dst.x = origin.x + quad->rect_dst.x * scale;
+		queued.rect_dst.y = origin.y + quad->rect_dst.y * scale;
+		queued.rect_dst.w = quad->rect_dst.w * scale;
+		queued.rect_dst.h = quad->rect_dst.h * scale;
+		queued.tint = SDL_FColor { tint.r, tint.g, tint.b, tint.a };
+		queued.order = stbds_arrlen(sys_text_data.queue);
+		stbds_arrput(sys_text_data.queue, queued);
+	}
+}
+
+int itu_sys_text_queued_quad_compare(const void* a, const void* b)
+{
+	const ITU_TextQueuedQuad* quad_a = (const ITU_TextQueuedQuad*)a;
+	const ITU_TextQueuedQuad* quad_b = (const ITU_TextQueuedQuad*)b;
+
+	if(quad_a->texture != quad_b->texture)
+		return quad_a->texture < quad_b->texture ? -1 : 1;
+	return quad_a->order - quad_b->order;
+}
+
+static void itu_sys_text_layouts_evict()
+{
+	for(int i = 0; i < stbds_hmlen(sys_text_data.layouts); )
+	{
+		ITU_TextLayout* layout = sys_text_data.layouts[i].value;
+		if(sys_text_data.flushes_count - layout->flush_last_used <= ITU_TEXT_LAYOUT_UNUSED_MAX)
+		{
+			++i;
+			continue;
+		}
+
+		SDL_free(layout->text);
+		stbds_arrfree(layout->quads);
+		SDL_free(layout);
+		// NOTE: hmdel moves the last element in this slot, so we don't advance
+		stbds_hmdel(sys_text_data.layouts, sys_text_data.layouts[i].key);
+	}
+}
+
+// draws all queued text, one draw call per atlas page
+void itu_sys_text_flush(SDLContext* context)
+{
+	ITU_TextQueuedQuad* quads = sys_text_data.queue;
+	int quads_count = stbds_arrlen(quads);
+
+	sys_text_data.flushes_count++;
+	if(sys_text_data.flushes_count % ITU_TEXT_LAYOUT_UNUSED_MAX == 0)
+		itu_sys_text_layouts_evict();
+
+	if(quads_count == 0)
+		return;
+
+	SDL_qsort(quads, quads_count, sizeof(ITU_TextQueuedQuad), itu_sys_text_queued_quad_compare);
+
+	int indices_count_old = stbds_arrlen(sys_text_data.indices);
+	if(indices_count_old < quads_count * 6)
+	{
+		stbds_arrsetlen(sys_text_data.indices, quads_count * 6);
+		for(int i = indices_count_old / 6; i < quads_count; ++i)
+		{
+			int* quad_indices = &sys_text_data.indices[i * 6];
+			quad_indices[0] = i * 4 + 0;
+			quad_indices[1] = i * 4 + 1;
+			quad_indices[2] = i * 4 + 2;
+			quad_indices[3] = i * 4 + 0;
+			quad_indices[4] = i * 4 + 2;
+			quad_indices[5] = i * 4 + 3;
+		}
+	}
+
+	stbds_arrsetlen(sys_text_data.vertices, quads_count * 4);
+	SDL_Vertex* vertices = sys_text_data.vertices;
+	for(int i = 0; i < quads_count; ++i)
+	{
+		ITU_TextQueuedQuad* quad = &quads[i];
+		float u_min = quad->rect_src.x / ITU_TEXT_ATLAS_PAGE_SIZE;
+		float v_min = quad->rect_src.y / ITU_TEXT_ATLAS_PAGE_SIZE;
+		float u_max = (quad->rect_src.x + quad->rect_src.w) / ITU_TEXT_ATLAS_PAGE_SIZE;
+		float v_max = (quad->rect_src.y + quad->rect_src.h) / ITU_TEXT_ATLAS_PAGE_SIZE;
+		float x_min = quad->rect_dst.x;
+		float y_min = quad->rect_dst.y;
+		float x_max = quad->rect_dst.x + quad->rect_dst.w;
+		float y_max = quad->rect_dst.y + quad->rect_dst.h;
+
+		SDL_Vertex* v = &vertices[i * 4];
+		v[0].position = SDL_FPoint { x_min, y_min };
+		v[1].position = SDL_FPoint { x_max, y_min };
+		v[2].position = SDL_FPoint { x_max, y_max };
+		v[3].position = SDL_FPoint { x_min, y_max };
+		v[0].tex_coord = SDL_FPoint { u_min, v_min };
+		v[1].tex_coord = SDL_FPoint { u_max, v_min };
+		v[2].tex_coord = SDL_FPoint { u_max, v_max };
+		v[3].tex_coord = SDL_FPoint { u_min, v_max };
+		v[0].color = quad->tint;
+		v[1].color = quad->tint;
+		v[2].color = quad->tint;
+		v[3].color = quad->tint;
+	}
+
+	int run_beg = 0;
+	while(run_beg < quads_count)
+	{
+		int run_end = run_beg + 1;
+		while(run_end < quads_count && quads[run_end].texture == quads[run_beg].texture)
+			++run_end;
+
+		int run_count = run_end - run_beg;
+		itu_sys_renderstats_render_geometry(
+			context,
+			quads[run_beg].texture,
+			&vertices[run_beg * 4], run_count * 4,
+			sys_text_data.indices, run_count * 6
+		);
+
+		run_beg = run_end;
+	}
+
+	stbds_arrsetlen(sys_text_data.queue, 0);
+}
+
+// releases all atlases and cached layouts (ie, before closing the fonts)
+void itu_sys_text_clear()
+{
+	for(int i = 0; i < stbds_hmlen(sys_text_data.atlases); ++i)
+		itu_sys_text_atlas_reset(&sys_text_data.atlases[i].value);
+	stbds_hmfree(sys_text_data.atlases);
+
+	for(int i = 0; i < stbds_hmlen(sys_text_data.layouts); ++i)
+	{
+		ITU_TextLayout* layout = sys_text_data.layouts[i].value;
+		SDL_free(layout->text);
+		stbds_arrfree(layout->quads);
+		SDL_free(layout);
+	}
+	stbds_hmfree(sys_text_data.layouts);
+
+	stbds_arrsetlen(sys_text_data.queue, 0);
+}
+
+#endif // (defined ITU_SYS_TEXT_IMPLEMENTATION) || (defined ITU_UNITY_BUILD)
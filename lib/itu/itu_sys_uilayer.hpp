@@ -0,0 +1,159 @@
+// itu_sys_uilayer.hpp
+// retained UI layer: screen-space UI is rendered into a cached target texture, and only redrawn when something changed.
+// Every frame the layer is composited on top of the game view with a single quad.
+//
+// usage (every frame)
+// - feed the state the UI depends on with `itu_sys_uilayer_hash` (ie, UI components data)
+// - `itu_sys_uilayer_begin`: if the hash differs from the previous frame (or the viewport changed, or the layer was
+//   invalidated) it binds the layer as render target and returns true
+// - draw the UI only if `itu_sys_uilayer_is_redrawing`, game logic (ie, button hover) runs anyway
+// - `itu_sys_uilayer_end` restores the previous target and composites the layer
+//
+// the layer covers the current viewport (ie, the active camera), at the current render scale
+//
+// limitations
+// - state that is not hashed (ie, font size changes) requires an explicit `itu_sys_uilayer_invalidate`
+// - the layer is premultiplied (what you get rendering with alpha blending on a transparent target), so it is composited with
+//   SDL_BLENDMODE_BLEND_PREMULTIPLIED
+
+#ifndef ITU_SYS_UILAYER_HPP
+#define ITU_SYS_UILAYER_HPP
+
+#ifndef ITU_UNITY_BUILD
+#include <SDL3/SDL.h>
+#include <stb_ds.h>
+#include <itu_common.hpp>
+#include <itu_lib_engine.hpp>
+#include <itu_sys_renderstats.hpp>
+#endif
+
+void itu_sys_uilayer_hash(const void* data, size_t size);
+void itu_sys_uilayer_invalidate();
+bool itu_sys_uilayer_begin(SDLContext* context);
+bool itu_sys_uilayer_is_redrawing();
+void itu_sys_uilayer_end(SDLContext* context);
+void itu_sys_uilayer_destroy();
+int  itu_sys_uilayer_get_redraws_count();
+
+#endif // ITU_SYS_UILAYER_HPP
+
+#if (defined ITU_SYS_UILAYER_IMPLEMENTATION) || (defined ITU_UNITY_BUILD)
+
+struct SysUILayer
+{
+	SDL_Texture* texture;
+	SDL_Texture* target_prev;
+	SDL_Rect     viewport;
+	vec2f        scale;
+
+	size_t hash_curr; // state hash accumulated during this frame
+	size_t hash_prev; // state hash of the last redraw
+	bool   invalidated;
+	bool   redrawing;
+
+	int redraws_count;
+};
+
+SysUILayer sys_uilayer_data;
+
+void itu_sys_uilayer_hash(const void* data, size_t size)
+{
+	sys_uilayer_data.hash_curr = stbds_hash_bytes((void*)data, size, sys_uilayer_data.hash_curr);
+}
+
+void itu_sys_uilayer_invalidate()
+{
+	sys_uilayer_data.invalidated = true;
+}
+
+bool itu_sys_uilayer_begin(SDLContext* context)
+{
+	SDL_Rect viewport;
+	vec2f scale;
+	SDL_GetRenderViewport(context->renderer, &viewport);
+	SDL_GetRenderScale(context->renderer, &scale.x, &scale.y);
+
+	int w = (int)(viewport.w * scale.x);
+	int h = (int)(viewport.h * scale.y);
+	if(w <= 0 || h <= 0)
+		return false;
+
+	bool resized = !sys_uilayer_data.texture || sys_uilayer_data.texture->w != w || sys_uilayer_data.texture->h != h;
+	if(resized)
+	{
+		SDL_DestroyTexture(sys_uilayer_data.texture);
+		sys_uilayer_data.texture = SDL_CreateTexture(context->renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET, w, h);
+		if(!sys_uilayer_data.texture)
+		{
+			SDL_Log("ERROR creating UI layer texture: %s", SDL_GetError());
+			return false;
+		}
+		SDL_SetTextureBlendMode(sys_uilayer_data.texture, SDL_BLENDMODE_BLEND_PREMULTIPLIED);
+		SDL_SetTextureScaleMode(sys_uilayer_data.texture, SDL_SCALEMODE_NEAREST);
+	}
+
+	sys_uilayer_data.redrawing =
+		resized ||
+		sys_uilayer_data.invalidated ||
+		sys_uilayer_data.hash_curr != sys_uilayer_data.hash_prev ||
+		SDL_memcmp(&viewport, &sys_uilayer_data.viewport, sizeof(SDL_Rect)) != 0 ||
+		scale.x != sys_uilayer_data.scale.x || scale.y != sys_uilayer_data.scale.y;
+
+	sys_uilayer_data.viewport = viewport;
+	sys_uilayer_data.scale = scale;
+
+	if(!sys_uilayer_data.redrawing)
+		return false;
+
+	sys_uilayer_data.hash_prev = sys_uilayer_data.hash_curr;
+	sys_uilayer_data.invalidated = false;
+	sys_uilayer_data.redraws_count++;
+
+	// NOTE: viewport and scale are per-target state in SDL3, so we set the same scale on the layer (viewport is the whole texture,
+	//       that matches coordinates relative to the current viewport)
+	sys_uilayer_data.target_prev = SDL_GetRenderTarget(context->renderer);
+	SDL_SetRenderTarget(context->renderer, sys_uilayer_data.texture);
+	SDL_SetRenderScale(context->renderer, scale.x, scale.y);
+	SDL_SetRenderDrawColor(context->renderer, 0, 0, 0, 0);
+	SDL_RenderClear(context->renderer);
+
+	return true;
+}
+
+bool itu_sys_uilayer_is_redrawing()
+{
+	return sys_uilayer_data.redrawing;
+}
+
+void itu_sys_uilayer_end(SDLContext* context)
+{
+	if(sys_uilayer_data.redrawing)
+	{
+		SDL_SetRenderTarget(context->renderer, sys_uilayer_data.target_prev);
+		sys_uilayer_data.redrawing = false;
+	}
+
+	// new frame, new hash
+	sys_uilayer_data.hash_curr = 0;
+
+	if(!sys_uilayer_data.texture)
+		return;
+
+	// layer is in pixels, destination is in (scaled) viewport coordinates
+	SDL_FRect rect_dst = { 0, 0, (float)sys_uilayer_data.viewport.w, (float)sys_uilayer_data.viewport.h };
+	SDL_RenderTexture(context->renderer, sys_uilayer_data.texture, NULL, &rect_dst);
+	itu_sys_renderstats_record(context, sys_uilayer_data.texture, SDL_BLENDMODE_BLEND_PREMULTIPLIED, 4, (float)(sys_uilayer_data.texture->w * sys_uilayer_data.texture->h));
+}
+
+void itu_sys_uilayer_destroy()
+{
+	SDL_DestroyTexture(sys_uilayer_data.texture);
+	sys_uilayer_data = { 0 };
+}
+
+int itu_sys_uilayer_get_redraws_count()
+{
+	return sys_uilayer_data.redraws_count;
+}
+
+#endif // (defined ITU_SYS_UILAYER_IMPLEMENTATION) || (defined ITU_UNITY_BUILD)
@@ -5,6 +5,7 @@
 
 #define STB_DS_IMPLEMENTATION
 #define STB_IMAGE_IMPLEMENTATION
+#define STB_RECT_PACK_IMPLEMENTATION
 
 #include <SDL3/SDL.h>
 #include <SDL3_mixer/SDL_mixer.h>
@@ -16,6 +17,8 @@
 #include <imgui/imgui.h>
 #include <imgui/imgui_impl_sdl3.h>
 #include <imgui/imgui_impl_sdlrenderer3.h>
+// NOTE: imgui compiles its own private copy of the rect packer, this is the one used by the resource storage atlas
+#include <imgui/imstb_rectpack.h>
 
 #include <box2d/box2d.h>
 
@@ -23,13 +26,24 @@
 #include <itu_lib_engine.hpp>
 
 #include <itu_lib_fileutils.hpp>
+#include <itu_lib_assetpack.hpp>
+#include <itu_sys_jobs.hpp>
 
 #include <itu_entity_storage.hpp>
 #include <itu_resource_storage.hpp>
 
 #include <itu_lib_render.hpp>
+#include <itu_sys_renderstats.hpp>
 #include <itu_lib_overlaps.hpp>
 #include <itu_lib_sprite.hpp>
+#include <itu_lib_spritesheet.hpp>
+#include <itu_sys_render.hpp>
+#include <itu_sys_simthread.hpp>
+#include <itu_sys_particles.hpp>
+#include <itu_sys_text.hpp>
+#include <itu_sys_uilayer.hpp>
+#include <itu_sys_lowres.hpp>
+#include <itu_lib_tilemap.hpp>
 #include <itu_lib_imgui.hpp>
 // #include <itu_lib_box2d.hpp> // deprecated
 #include <itu_sys_physics.hpp>